@@ -348,7 +348,7 @@ bool mmBudgetingPanel::DisplayEntryAllowed(int categoryID, int subcategoryID)
     }
     else
     {
-        actual = categoryStats_[categoryID][subcategoryID][0];
+        actual = categoryStats_(categoryID, subcategoryID, 0);
         estimated = getEstimate(categoryID, subcategoryID);
     }
 
@@ -374,7 +374,7 @@ void mmBudgetingPanel::initVirtualListControl()
     budgetTotals_.clear();
     budgetPeriod_.clear();
     budgetAmt_.clear();
-    categoryStats_.clear();
+    categoryStats_ = Model_Category::Stats();
     double estIncome = 0.0;
     double estExpenses = 0.0;
     double actIncome = 0.0;
@@ -433,7 +433,7 @@ void mmBudgetingPanel::initVirtualListControl()
         double actual = 0;
         if (currentView_ != VIEW_PLANNED || estimated != 0)
         {
-            actual = categoryStats_[category.CATEGID][-1][0];
+            actual = categoryStats_(category.CATEGID, -1, 0);
             if (actual < 0)
                 actExpenses += actual;
             else
@@ -462,7 +462,7 @@ void mmBudgetingPanel::initVirtualListControl()
             actual = 0;
             if (currentView_ != VIEW_PLANNED || estimated != 0)
             {
-                actual = categoryStats_[category.CATEGID][subcategory.SUBCATEGID][0];
+                actual = categoryStats_(category.CATEGID, subcategory.SUBCATEGID, 0);
                 if (actual < 0)
                     actExpenses += actual;
                 else
@@ -600,7 +600,7 @@ wxString mmBudgetingPanel::getItem(long item, long column)
         }
         else
         {
-            double actual = categoryStats_[budget_[item].first][budget_[item].second][0];
+            double actual = categoryStats_(budget_[item].first, budget_[item].second, 0);
             return Model_Currency::toCurrency(actual);
         }
     }
@@ -625,7 +625,7 @@ int mmBudgetingPanel::GetItemImage(long item) const
     else
     {
         estimated = getEstimate(budget_[item].first, budget_[item].second);
-        actual = categoryStats_.at(budget_[item].first).at(budget_[item].second).at(0);
+        actual = categoryStats_(budget_[item].first, budget_[item].second, 0);
     }
 
     if ((estimated == 0.0) && (actual == 0.0)) return 3;
@@ -682,7 +682,7 @@ void mmBudgetingPanel::OnListItemActivated(int selectedIndex)
         entry = &budget[0];
 
     double estimated = getEstimate(budget_[selectedIndex].first, budget_[selectedIndex].second);
-    double actual = categoryStats_[budget_[selectedIndex].first][budget_[selectedIndex].second][0];
+    double actual = categoryStats_(budget_[selectedIndex].first, budget_[selectedIndex].second, 0);
 
     mmBudgetEntryDialog dlg(this, entry, Model_Currency::toCurrency(estimated), Model_Currency::toCurrency(actual));
     if (dlg.ShowModal() == wxID_OK)
@@ -20,6 +20,7 @@
 
 #include "mmpanelbase.h"
 #include "Model_Budget.h"
+#include "Model_Category.h"
 
 class wxListCtrl;
 class wxListEvent;
@@ -96,7 +97,7 @@ private:
     std::map<int, std::pair<double, double> > budgetTotals_;
     std::map<int, std::map<int, Model_Budget::PERIOD_ENUM> > budgetPeriod_;
     std::map<int, std::map<int, double> > budgetAmt_;
-    std::map<int, std::map<int, std::map<int, double> > > categoryStats_;
+    Model_Category::Stats categoryStats_;
     bool monthlyBudget_;
     budgetingListCtrl* listCtrlBudget_;
     wxString currentView_;
@@ -13,11 +13,16 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <tuple>
+#include <new>
 #include <algorithm>
 #include <functional>
 #include <wx/wxsqlite3.h>
 #include <wx/intl.h>
 #include <wx/log.h>
+#include <wx/datetime.h>
+#include <wx/stopwatch.h>
 
 #include "rapidjson/document.h"
 #include "rapidjson/pointer.h"
@@ -28,24 +33,241 @@ using namespace rapidjson;
 #include <html_template.h>
 using namespace tmpl;
 
-class wxString;
+#if (wxMAJOR_VERSION == 3 && wxMINOR_VERSION >= 1)
+    // wx 3.1 has implemented such hash
+#else
+namespace std
+{
+    template<>
+    struct hash<wxString>
+    {
+        size_t operator()(const wxString& k) const
+        {
+            return std::hash<std::wstring>()(k.ToStdWstring());
+        }
+    };
+}
+#endif
+
 enum OP { EQUAL = 0, GREATER, LESS, GREATER_OR_EQUAL, LESS_OR_EQUAL, NOT_EQUAL };
 
+/**
+* A calendar day packed as the integer yyyymmdd, decoded from the ISO 8601 "YYYY-MM-DD"
+* text of a date column; 0 when the text is not such a date. Ordered like the dates.
+*/
+class DB_Date
+{
+public:
+    DB_Date(): ymd_(0) {}
+    explicit DB_Date(int ymd): ymd_(ymd) {}
+    explicit DB_Date(const wxString& iso_date): ymd_(parse(iso_date)) {}
+    explicit DB_Date(const wxDateTime& date): ymd_(date.IsValid()
+        ? date.GetYear() * 10000 + (date.GetMonth() + 1) * 100 + date.GetDay() : 0) {}
+
+    int ymd() const { return ymd_; }
+    int year() const { return ymd_ / 10000; }
+    /** 1 for January */
+    int month() const { return ymd_ / 100 % 100; }
+    int day() const { return ymd_ % 100; }
+    /** yyyymm, the key of monthly buckets */
+    int year_month() const { return ymd_ / 100; }
+    bool is_valid() const { return ymd_ != 0; }
+
+    /** Days since 1970-01-01, so the difference of two dates is their distance in days */
+    int days() const
+    {
+        const int y = year() - (month() <= 2 ? 1 : 0);
+        const int era = (y >= 0 ? y : y - 399) / 400;
+        const int yoe = y - era * 400;
+        const int doy = (153 * (month() + (month() > 2 ? -3 : 9)) + 2) / 5 + day() - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    wxDateTime to_date() const
+    {
+        if (!is_valid()) return wxInvalidDateTime;
+        return wxDateTime(day(), static_cast<wxDateTime::Month>(month() - 1), year());
+    }
+
+    bool operator < (const DB_Date& r) const { return ymd_ < r.ymd_; }
+    bool operator <= (const DB_Date& r) const { return ymd_ <= r.ymd_; }
+    bool operator > (const DB_Date& r) const { return ymd_ > r.ymd_; }
+    bool operator >= (const DB_Date& r) const { return ymd_ >= r.ymd_; }
+    bool operator == (const DB_Date& r) const { return ymd_ == r.ymd_; }
+    bool operator != (const DB_Date& r) const { return ymd_ != r.ymd_; }
+
+    /** Decode "YYYY-MM-DD" strictly like wxDateTime::ParseISODate(), 0 on failure */
+    static int parse(const wxString& iso_date)
+    {
+        if (iso_date.length() != 10) return 0;
+        int v[3] = { 0, 0, 0 };
+        int part = 0;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            const wchar_t c = static_cast<wchar_t>(iso_date[i]);
+            if (i == 4 || i == 7)
+            {
+                if (c != L'-') return 0;
+                ++part;
+            }
+            else if (c >= L'0' && c <= L'9')
+                v[part] = v[part] * 10 + (c - L'0');
+            else
+                return 0;
+        }
+
+        static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        const int year = v[0], month = v[1], day = v[2];
+        if (month < 1 || month > 12 || day < 1) return 0;
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        if (day > days[month - 1] + (month == 2 && leap ? 1 : 0)) return 0;
+
+        return year * 10000 + month * 100 + day;
+    }
+
+private:
+    int ymd_;
+};
+
 template<class V>
 struct DB_Column
 {
+    typedef V value_type;
     V v_;
     OP op_;
     DB_Column(const V& v, OP op = EQUAL): v_(v), op_(op)
     {}
 };
 
+/** Shape of a cached query: the table, the column/operator signature and the AND/OR mode */
+struct DB_Statement_Key
+{
+    wxString table_;
+    wxString signature_;
+    bool op_and_;
+    DB_Statement_Key(const wxString& table, const wxString& signature, bool op_and)
+        : table_(table), signature_(signature), op_and_(op_and)
+    {}
+
+    bool operator < (const DB_Statement_Key& r) const
+    {
+        if (table_ != r.table_) return table_ < r.table_;
+        if (op_and_ != r.op_and_) return op_and_ < r.op_and_;
+        return signature_ < r.signature_;
+    }
+};
+
+/**
+* Prepared statements kept per database connection.
+* A statement is prepared once for each query shape,
+* then reset and rebound on every later use.
+* Shapes vary with the length of IN lists and LIMIT counts, so each connection keeps
+* at most MAX_STATEMENTS of them and finalizes the least recently used one beyond.
+*/
+class DB_Statement_Cache
+{
+public:
+    enum { MAX_STATEMENTS = 128 };
+
+public:
+    static DB_Statement_Cache& instance()
+    {
+        static DB_Statement_Cache cache;
+        return cache;
+    }
+
+    /** Return the statement for the key, preparing sql when it is not cached yet */
+    wxSQLite3Statement& get(wxSQLite3Database* db, const DB_Statement_Key& key, const wxString& sql, bool& reused)
+    {
+        Statements& statements = connections_[db];
+        Statements::iterator it = statements.find(key);
+        reused = (it != statements.end());
+        if (reused)
+        {
+            it->second.used_ = ++ tick_;
+            it->second.stmt_.Reset();
+            it->second.stmt_.ClearBindings();
+            return it->second.stmt_;
+        }
+
+        if (statements.size() >= MAX_STATEMENTS)
+            evict(statements);
+        Entry& entry = statements[key];
+        entry.stmt_ = db->PrepareStatement(sql);
+        entry.used_ = ++ tick_;
+        return entry.stmt_;
+    }
+
+    /** Drop the statement for the key, e.g. after it failed */
+    void erase(wxSQLite3Database* db, const DB_Statement_Key& key)
+    {
+        connections_[db].erase(key);
+    }
+
+    /** Drop all statements of the connection touching the table */
+    void erase(wxSQLite3Database* db, const wxString& table)
+    {
+        Statements& statements = connections_[db];
+        for (Statements::iterator it = statements.begin(); it != statements.end();)
+        {
+            if (it->first.table_ == table)
+                statements.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    /** Finalize all statements of the connection. Must be called before it is closed. */
+    void reset(wxSQLite3Database* db)
+    {
+        std::map<wxSQLite3Database*, Statements>::iterator it = connections_.find(db);
+        if (it == connections_.end()) return;
+
+        for (auto& item : it->second)
+            item.second.stmt_.Finalize();
+        connections_.erase(it);
+    }
+
+private:
+    struct Entry
+    {
+        wxSQLite3Statement stmt_;
+        size_t used_; // tick_ of the last get()
+    };
+    typedef std::map<DB_Statement_Key, Entry> Statements;
+
+    DB_Statement_Cache(): tick_(0) {}
+
+    /** Finalize the least recently used statement */
+    void evict(Statements& statements)
+    {
+        Statements::iterator oldest = statements.begin();
+        for (Statements::iterator it = statements.begin(); it != statements.end(); ++it)
+        {
+            if (it->second.used_ < oldest->second.used_) oldest = it;
+        }
+        oldest->second.stmt_.Finalize();
+        statements.erase(oldest);
+    }
+
+    std::map<wxSQLite3Database*, Statements> connections_;
+    size_t tick_;
+};
+
 struct DB_Table
 {
-    DB_Table(): hit_(0), miss_(0), skip_(0) {};
+    DB_Table(): hit_(0), miss_(0), skip_(0), evict_(0), stmt_hit_(0), stmt_miss_(0), cache_complete_(false)
+        , cache_bytes_(0), cache_budget_(0), revision_(0) {};
     virtual ~DB_Table() {};
     wxString query_;
-    size_t hit_, miss_, skip_;
+    size_t hit_, miss_, skip_, evict_;
+    size_t stmt_hit_, stmt_miss_;
+    bool cache_complete_; // every record of the table is in the memory table (cache)
+    size_t cache_bytes_; // approximate memory held by the memory table (cache)
+    size_t cache_budget_; // memory allowed to the memory table (cache) by shrink(), 0 is unbounded
+    std::map<int, int> pins_; // pin count by id of the records shrink() must keep
+    size_t revision_; // bumped by every change of the records, so derived data can tell it is stale
     virtual wxString query() const { return this->query_; }
     virtual size_t num_columns() const = 0;
     virtual wxString name() const = 0;
@@ -57,15 +279,285 @@ struct DB_Table
 
     void drop(wxSQLite3Database* db) const
     {
+        DB_Statement_Cache::instance().erase(db, this->name());
         db->ExecuteUpdate("DROP TABLE IF EXISTS " + this->name());
     }
+
+    /** Keep the record with the id in memory until unpin(), e.g. while a dialog refers to it */
+    void pin(int id)
+    {
+        if (id > 0) ++ pins_[id];
+    }
+
+    void unpin(int id)
+    {
+        auto it = pins_.find(id);
+        if (it != pins_.end() && -- it->second == 0) pins_.erase(it);
+    }
+
+    bool pinned(int id) const
+    {
+        return pins_.find(id) != pins_.end();
+    }
+
+    /** Return the cached prepared statement for the query shape */
+    wxSQLite3Statement& statement(wxSQLite3Database* db, const wxString& signature, bool op_and, const wxString& sql)
+    {
+        bool reused = false;
+        wxSQLite3Statement& stmt = DB_Statement_Cache::instance().get(db
+            , DB_Statement_Key(this->name(), signature, op_and), sql, reused);
+        if (reused)
+            ++ stmt_hit_;
+        else
+            ++ stmt_miss_;
+        return stmt;
+    }
+
+    /** Forget the cached statement for the query shape, so it is prepared again on next use */
+    void forget_statement(wxSQLite3Database* db, const wxString& signature, bool op_and)
+    {
+        DB_Statement_Cache::instance().erase(db, DB_Statement_Key(this->name(), signature, op_and));
+    }
 };
 
-template<typename Arg1>
-void condition(wxString& out, bool /*op_and*/, const Arg1& arg1)
+/**
+* Slab allocator for the Data records of a table. Records are constructed in slabs of
+* SLAB_SIZE, destroyed slots are reused, and clear() releases every slab in one step.
+*/
+template<class DATA>
+class DB_Arena
 {
-    out += Arg1::name();
-    switch (arg1.op_)
+public:
+    enum { SLAB_SIZE = 256 };
+
+    DB_Arena(): next_(SLAB_SIZE), size_(0) {}
+    ~DB_Arena() { release(); }
+
+    template<typename... Args>
+    DATA* create(Args&&... args)
+    {
+        void* slot = allocate();
+        try
+        {
+            return new (slot) DATA(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(static_cast<DATA*>(slot));
+            throw;
+        }
+    }
+
+    void destroy(DATA* data)
+    {
+        data->~DATA();
+        deallocate(data);
+    }
+
+    /** Destroy the live records, which must be all the records of the arena, and release the slabs */
+    template<class CONTAINER>
+    void clear(const CONTAINER& live)
+    {
+        for (DATA* data : live) data->~DATA();
+        release();
+    }
+
+    /** Number of live records */
+    size_t size() const { return size_; }
+    /** Bytes held by the slabs, not counting what the records allocate themselves */
+    size_t bytes() const { return slabs_.size() * SLAB_SIZE * sizeof(DATA); }
+
+private:
+    void* allocate()
+    {
+        ++size_;
+        if (!free_.empty())
+        {
+            DATA* slot = free_.back();
+            free_.pop_back();
+            return slot;
+        }
+        if (next_ == SLAB_SIZE)
+        {
+            slabs_.push_back(static_cast<DATA*>(::operator new(SLAB_SIZE * sizeof(DATA))));
+            next_ = 0;
+        }
+        return slabs_.back() + next_++;
+    }
+
+    void deallocate(DATA* slot)
+    {
+        --size_;
+        free_.push_back(slot);
+    }
+
+    void release()
+    {
+        for (DATA* slab : slabs_) ::operator delete(slab);
+        slabs_.clear();
+        free_.clear();
+        next_ = SLAB_SIZE;
+        size_ = 0;
+    }
+
+    DB_Arena(const DB_Arena&);
+    DB_Arena& operator=(const DB_Arena&);
+
+    std::vector<DATA*> slabs_;
+    std::vector<DATA*> free_;
+    size_t next_;
+    size_t size_;
+};
+
+/**
+* Index of the cached records by primary key.
+* Primary keys are SQLite rowids, dense in practice, so records are addressed
+* directly by id in a vector. Ids far beyond the populated range go to a hash map.
+*/
+template<class DATA>
+class DB_Index_By_Id
+{
+public:
+    DB_Index_By_Id(): size_(0) {}
+
+    /** Return the record for the id, or 0 when it is not indexed */
+    DATA* find(int id) const
+    {
+        if (id <= 0) return 0;
+        if (static_cast<size_t>(id) < dense_.size()) return dense_[id];
+        if (sparse_.empty()) return 0;
+
+        typename std::unordered_map<int, DATA*>::const_iterator it = sparse_.find(id);
+        return it == sparse_.end() ? 0 : it->second;
+    }
+
+    /** Index the record, an already indexed id is kept */
+    void insert(int id, DATA* entity)
+    {
+        if (id <= 0 || find(id)) return;
+
+        if (static_cast<size_t>(id) >= dense_.size() && static_cast<size_t>(id) <= 2 * size_ + 1024)
+            grow(id + 1);
+
+        if (static_cast<size_t>(id) < dense_.size())
+            dense_[id] = entity;
+        else
+            sparse_[id] = entity;
+        ++ size_;
+    }
+
+    void erase(int id)
+    {
+        if (!find(id)) return;
+
+        if (static_cast<size_t>(id) < dense_.size())
+            dense_[id] = 0;
+        else
+            sparse_.erase(id);
+        -- size_;
+    }
+
+    void clear()
+    {
+        dense_.clear();
+        sparse_.clear();
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+
+    /** Return the first record in id order satisfying the predicate, or 0 */
+    template<class PREDICATE>
+    DATA* find_if(PREDICATE pred) const
+    {
+        for (size_t id = 1; id < dense_.size(); ++ id)
+        {
+            if (dense_[id] && pred(dense_[id])) return dense_[id];
+        }
+
+        DATA* found = 0;
+        for (const auto& item : sparse_)
+        {
+            if ((!found || item.first < found->id()) && pred(item.second))
+                found = item.second;
+        }
+        return found;
+    }
+
+private:
+    void grow(size_t new_size)
+    {
+        dense_.resize(std::max(new_size, dense_.size() * 2), 0);
+        for (typename std::unordered_map<int, DATA*>::iterator it = sparse_.begin(); it != sparse_.end();)
+        {
+            if (static_cast<size_t>(it->first) < dense_.size())
+            {
+                dense_[it->first] = it->second;
+                it = sparse_.erase(it);
+            }
+            else
+                ++ it;
+        }
+    }
+
+    std::vector<DATA*> dense_;
+    std::unordered_map<int, DATA*> sparse_;
+    size_t size_;
+};
+
+/**
+* In-memory secondary index of the cached records by a key built from non-key columns.
+* The key of every record is remembered, so it can be refreshed after the record changed.
+*/
+template<class DATA>
+class DB_Index_By_Key
+{
+public:
+    /** Return the record for the key, or 0 when it is not indexed */
+    DATA* find(const wxString& key) const
+    {
+        typename std::unordered_map<wxString, DATA*>::const_iterator it = by_key_.find(key);
+        return it == by_key_.end() ? 0 : it->second;
+    }
+
+    /** Index the record under the key, replacing the key it had before */
+    void insert(DATA* entity, const wxString& key)
+    {
+        erase(entity);
+        by_key_[key] = entity;
+        by_entity_[entity] = key;
+    }
+
+    void erase(DATA* entity)
+    {
+        typename std::unordered_map<const DATA*, wxString>::iterator it = by_entity_.find(entity);
+        if (it == by_entity_.end()) return;
+
+        typename std::unordered_map<wxString, DATA*>::iterator k = by_key_.find(it->second);
+        if (k != by_key_.end() && k->second == entity)
+            by_key_.erase(k);
+        by_entity_.erase(it);
+    }
+
+    void clear()
+    {
+        by_key_.clear();
+        by_entity_.clear();
+    }
+
+    size_t size() const { return by_key_.size(); }
+
+private:
+    std::unordered_map<wxString, DATA*> by_key_;
+    std::unordered_map<const DATA*, wxString> by_entity_;
+};
+
+/** Append the SQL of a single column comparison */
+template<typename Arg>
+void condition_term(wxString& out, const Arg& arg)
+{
+    out += Arg::name();
+    switch (arg.op_)
     {
     case GREATER:           out += " > ? ";     break;
     case GREATER_OR_EQUAL:  out += " >= ? ";    break;
@@ -77,46 +569,220 @@ void condition(wxString& out, bool /*op_and*/, const Arg1& arg1)
     }
 }
 
+/** Bind the value of a single column comparison, return the next parameter index */
+template<typename Arg>
+int bind_term(wxSQLite3Statement& stmt, int index, const Arg& arg)
+{
+    stmt.Bind(index, arg.v_);
+    return index + 1;
+}
+
+/** COLUMN IN (values) condition, e.g. IN_LIST<Model_Checking::ACCOUNTID>(account_ids) */
+template<class COLUMN>
+struct IN_LIST
+{
+    std::vector<typename COLUMN::value_type> values_;
+    explicit IN_LIST(const std::vector<typename COLUMN::value_type>& values): values_(values) {}
+};
+
+template<class COLUMN>
+void condition_term(wxString& out, const IN_LIST<COLUMN>& arg)
+{
+    out += COLUMN::name() + " IN (";
+    for (size_t i = 0; i < arg.values_.size(); ++i)
+        out += (i == 0 ? "?" : ", ?");
+    out += ") ";
+}
+
+template<class COLUMN>
+int bind_term(wxSQLite3Statement& stmt, int index, const IN_LIST<COLUMN>& arg)
+{
+    for (const auto& v : arg.values_)
+        stmt.Bind(index++, v);
+    return index;
+}
+
+/** COLUMN BETWEEN low AND high condition, both ends included */
+template<class COLUMN>
+struct BETWEEN
+{
+    typename COLUMN::value_type low_, high_;
+    BETWEEN(const typename COLUMN::value_type& low, const typename COLUMN::value_type& high): low_(low), high_(high) {}
+};
+
+template<class COLUMN>
+void condition_term(wxString& out, const BETWEEN<COLUMN>& /*arg*/)
+{
+    out += COLUMN::name() + " BETWEEN ? AND ? ";
+}
+
+template<class COLUMN>
+int bind_term(wxSQLite3Statement& stmt, int index, const BETWEEN<COLUMN>& arg)
+{
+    stmt.Bind(index, arg.low_);
+    stmt.Bind(index + 1, arg.high_);
+    return index + 2;
+}
+
+/** Parenthesized group of conditions, see ALL_OF() and ANY_OF() */
+template<bool OP_AND, typename... Args>
+struct DB_Group
+{
+    std::tuple<Args...> args_;
+    explicit DB_Group(const Args&... args): args_(args...) {}
+};
+
+/** The conditions joined by AND, e.g. find_or(ACCOUNTID(a), ALL_OF(TOACCOUNTID(a), TRANSCODE(t))) */
+template<typename... Args>
+DB_Group<true, Args...> ALL_OF(const Args&... args)
+{
+    return DB_Group<true, Args...>(args...);
+}
+
+/** The conditions joined by OR, e.g. find(ANY_OF(ACCOUNTID(a), TOACCOUNTID(a)), TRANSDATE(d, LESS)) */
+template<typename... Args>
+DB_Group<false, Args...> ANY_OF(const Args&... args)
+{
+    return DB_Group<false, Args...>(args...);
+}
+
+template<size_t N, typename TUPLE>
+struct DB_Group_Terms
+{
+    static void sql(wxString& out, bool op_and, const TUPLE& args)
+    {
+        DB_Group_Terms<N - 1, TUPLE>::sql(out, op_and, args);
+        if (N > 1) out += op_and ? " AND " : " OR ";
+        condition_term(out, std::get<N - 1>(args));
+    }
+
+    static int bind(wxSQLite3Statement& stmt, int index, const TUPLE& args)
+    {
+        return bind_term(stmt, DB_Group_Terms<N - 1, TUPLE>::bind(stmt, index, args), std::get<N - 1>(args));
+    }
+};
+
+template<typename TUPLE>
+struct DB_Group_Terms<0, TUPLE>
+{
+    static void sql(wxString& /*out*/, bool /*op_and*/, const TUPLE& /*args*/) {}
+    static int bind(wxSQLite3Statement& /*stmt*/, int index, const TUPLE& /*args*/) { return index; }
+};
+
+template<bool OP_AND, typename... Args>
+void condition_term(wxString& out, const DB_Group<OP_AND, Args...>& arg)
+{
+    out += "(";
+    DB_Group_Terms<sizeof...(Args), std::tuple<Args...> >::sql(out, OP_AND, arg.args_);
+    out += ") ";
+}
+
+template<bool OP_AND, typename... Args>
+int bind_term(wxSQLite3Statement& stmt, int index, const DB_Group<OP_AND, Args...>& arg)
+{
+    return DB_Group_Terms<sizeof...(Args), std::tuple<Args...> >::bind(stmt, index, arg.args_);
+}
+
+/**
+* ORDER BY COLUMN, e.g. ORDER_BY<Model_Checking::TRANSDATE>() or ORDER_BY<Model_Checking::TRANSDATE>(true)
+* for descending order. Passed along with the conditions; several ORDER_BY are applied in turn.
+*/
+template<class COLUMN>
+struct ORDER_BY
+{
+    bool descending_;
+    explicit ORDER_BY(bool descending = false): descending_(descending) {}
+};
+
+/** LIMIT count, passed along with the conditions */
+struct LIMIT
+{
+    int count_;
+    explicit LIMIT(int count): count_(count) {}
+};
+
+template<class COLUMN>
+void condition_term(wxString& /*out*/, const ORDER_BY<COLUMN>& /*arg*/) {}
+inline void condition_term(wxString& /*out*/, const LIMIT& /*arg*/) {}
+
+template<class COLUMN>
+int bind_term(wxSQLite3Statement& /*stmt*/, int index, const ORDER_BY<COLUMN>& /*arg*/) { return index; }
+inline int bind_term(wxSQLite3Statement& /*stmt*/, int index, const LIMIT& /*arg*/) { return index; }
+
+template<typename Arg>
+void clause_term(wxString& /*order*/, wxString& /*limit*/, const Arg& /*arg*/) {}
+
+template<class COLUMN>
+void clause_term(wxString& order, wxString& /*limit*/, const ORDER_BY<COLUMN>& arg)
+{
+    order += (order.empty() ? " ORDER BY " : ", ") + COLUMN::name() + (arg.descending_ ? " DESC" : "");
+}
+
+inline void clause_term(wxString& /*order*/, wxString& limit, const LIMIT& arg)
+{
+    limit = wxString::Format(" LIMIT %d", arg.count_);
+}
+
+inline void clause_terms(wxString& /*order*/, wxString& /*limit*/)
+{
+}
+
+template<typename Arg1, typename... Args>
+void clause_terms(wxString& order, wxString& limit, const Arg1& arg1, const Args&... args)
+{
+    clause_term(order, limit, arg1);
+    clause_terms(order, limit, args...);
+}
+
+/** Return the ORDER BY and LIMIT clauses given among the conditions */
+template<typename... Args>
+wxString clauses(const Args&... args)
+{
+    wxString order, limit;
+    clause_terms(order, limit, args...);
+    return order + limit;
+}
+
+inline void condition(wxString& /*out*/, bool /*op_and*/)
+{
+}
+
+/** Build the WHERE expression of the conditions, joined by AND or OR */
 template<typename Arg1, typename... Args>
 void condition(wxString& out, bool op_and, const Arg1& arg1, const Args&... args)
 {
-    out += Arg1::name();
-    switch (arg1.op_)
+    wxString term;
+    condition_term(term, arg1);
+    if (!term.empty())
     {
-    case GREATER:           out += " > ? ";     break;
-    case GREATER_OR_EQUAL:  out += " >= ? ";    break;
-    case LESS:              out += " < ? ";     break;
-    case LESS_OR_EQUAL:     out += " <= ? ";    break;
-    case NOT_EQUAL:         out += " != ? ";    break;
-    default:
-        out += " = ? "; break;
+        if (!out.empty()) out += op_and ? " AND " : " OR ";
+        out += term;
     }
-    out += op_and? " AND " : " OR ";
     condition(out, op_and, args...);
 }
 
-template<typename Arg1>
-void bind(wxSQLite3Statement& stmt, int index, const Arg1& arg1)
+inline void bind(wxSQLite3Statement& /*stmt*/, int /*index*/)
 {
-    stmt.Bind(index, arg1.v_);
 }
 
 template<typename Arg1, typename... Args>
 void bind(wxSQLite3Statement& stmt, int index, const Arg1& arg1, const Args&... args)
 {
-    stmt.Bind(index, arg1.v_);
-    bind(stmt, index+1, args...);
+    bind(stmt, bind_term(stmt, index, arg1), args...);
 }
 
 template<typename TABLE, typename... Args>
 const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool op_and, const Args&... args)
 {
     typename TABLE::Data_Set result;
+    wxString where;
+    condition(where, op_and, args...);
+    const wxString signature = where + clauses(args...);
     try
     {
-        wxString query = table->query() + " WHERE ";
-        condition(query, op_and, args...);
-        wxSQLite3Statement stmt = db->PrepareStatement(query);
+        wxString query = table->query();
+        if (!where.empty()) query += " WHERE " + where;
+        wxSQLite3Statement& stmt = table->statement(db, signature, op_and, query + clauses(args...));
         bind(stmt, 1, args...);
 
         wxSQLite3ResultSet q = stmt.ExecuteQuery();
@@ -127,16 +793,286 @@ const typename TABLE::Data_Set find_by(TABLE* table, wxSQLite3Database* db, bool
             result.push_back(std::move(entity));
         }
 
-        q.Finalize();
+        stmt.Reset();
     }
     catch(const wxSQLite3Exception &e)
     {
+        table->forget_statement(db, signature, op_and);
         wxLogError("%s: Exception %s", table->name().c_str(), e.GetMessage().c_str());
     }
 
     return result;
 }
 
+/**
+* Stream the records matching the conditions to the visitor one row at a time,
+* reusing a single Data buffer instead of materializing a Data_Set.
+* The visitor takes a const Data& and returns false to stop the iteration.
+* The statement does not come from the statement cache, so the visitor is free
+* to query the same table again.
+*/
+template<typename TABLE, typename VISITOR, typename... Args>
+void for_each_by(TABLE* table, wxSQLite3Database* db, bool op_and, VISITOR visitor, const Args&... args)
+{
+    try
+    {
+        wxString where;
+        condition(where, op_and, args...);
+        wxString query = table->query();
+        if (!where.empty()) query += " WHERE " + where;
+        wxSQLite3Statement stmt = db->PrepareStatement(query + clauses(args...));
+        bind(stmt, 1, args...);
+
+        wxSQLite3ResultSet q = stmt.ExecuteQuery();
+
+        typename TABLE::Data entity(table);
+        while(q.NextRow())
+        {
+            entity.load(q);
+            if (!visitor(static_cast<const typename TABLE::Data&>(entity))) break;
+        }
+
+        stmt.Finalize();
+    }
+    catch(const wxSQLite3Exception &e)
+    {
+        wxLogError("%s: Exception %s", table->name().c_str(), e.GetMessage().c_str());
+    }
+}
+
+inline void get_value(wxSQLite3ResultSet& q, int col, int& v) { v = q.GetInt(col); }
+inline void get_value(wxSQLite3ResultSet& q, int col, double& v) { v = q.GetDouble(col); }
+inline void get_value(wxSQLite3ResultSet& q, int col, wxString& v) { v = q.GetString(col); }
+
+template<size_t N, typename TUPLE>
+struct DB_Tuple_Loader
+{
+    static void load(wxSQLite3ResultSet& q, TUPLE& row)
+    {
+        DB_Tuple_Loader<N - 1, TUPLE>::load(q, row);
+        get_value(q, N - 1, std::get<N - 1>(row));
+    }
+};
+
+template<typename TUPLE>
+struct DB_Tuple_Loader<0, TUPLE>
+{
+    static void load(wxSQLite3ResultSet& /*q*/, TUPLE& /*row*/) {}
+};
+
+/** Rows holding only the given columns, in the given order */
+template<typename... COLUMNS>
+struct DB_Projection
+{
+    typedef std::tuple<typename COLUMNS::value_type...> Row;
+    typedef std::vector<Row> Row_Set;
+
+    static wxString columns()
+    {
+        const wxString names[] = { COLUMNS::name()... };
+        wxString out;
+        for (const auto& name : names)
+        {
+            if (!out.empty()) out += ", ";
+            out += name;
+        }
+        return out;
+    }
+};
+
+/**
+* Return the values of the given columns for the records matching the conditions.
+* Only the projected columns are read from the database.
+*/
+template<typename... COLUMNS, typename TABLE, typename... Args>
+const typename DB_Projection<COLUMNS...>::Row_Set select_by(TABLE* table, wxSQLite3Database* db, bool op_and, const Args&... args)
+{
+    typedef DB_Projection<COLUMNS...> Projection;
+    typename Projection::Row_Set result;
+    wxString signature = "SELECT " + Projection::columns();
+    wxString where;
+    condition(where, op_and, args...);
+    if (!where.empty()) signature += " WHERE " + where;
+    signature += clauses(args...);
+    try
+    {
+        wxString query = "SELECT " + Projection::columns() + " FROM " + table->name();
+        if (!where.empty()) query += " WHERE " + where;
+        wxSQLite3Statement& stmt = table->statement(db, signature, op_and, query + clauses(args...));
+        bind(stmt, 1, args...);
+
+        wxSQLite3ResultSet q = stmt.ExecuteQuery();
+
+        typename Projection::Row row;
+        while(q.NextRow())
+        {
+            DB_Tuple_Loader<sizeof...(COLUMNS), typename Projection::Row>::load(q, row);
+            result.push_back(row);
+        }
+
+        stmt.Reset();
+    }
+    catch(const wxSQLite3Exception &e)
+    {
+        table->forget_statement(db, signature, op_and);
+        wxLogError("%s: Exception %s", table->name().c_str(), e.GetMessage().c_str());
+    }
+
+    return result;
+}
+
+/** New value of a column for update_by(), e.g. SET<Model_Payee::CATEGID>(-1) */
+template<class COLUMN>
+struct SET
+{
+    typedef COLUMN column_type;
+    COLUMN column_;
+    explicit SET(const typename COLUMN::value_type& v): column_(v) {}
+};
+
+template<size_t N, typename SETS>
+struct DB_Assignments
+{
+    static void sql(wxString& out)
+    {
+        DB_Assignments<N - 1, SETS>::sql(out);
+        if (N > 1) out += ", ";
+        out += std::tuple_element<N - 1, SETS>::type::column_type::name() + " = ?";
+    }
+
+    static void bind(wxSQLite3Statement& stmt, const SETS& sets)
+    {
+        DB_Assignments<N - 1, SETS>::bind(stmt, sets);
+        stmt.Bind(N, std::get<N - 1>(sets).column_.v_);
+    }
+
+    template<class DATA>
+    static void apply(DATA* data, const SETS& sets)
+    {
+        DB_Assignments<N - 1, SETS>::apply(data, sets);
+        data->assign(std::get<N - 1>(sets).column_);
+    }
+};
+
+template<typename SETS>
+struct DB_Assignments<0, SETS>
+{
+    static void sql(wxString& /*out*/) {}
+    static void bind(wxSQLite3Statement& /*stmt*/, const SETS& /*sets*/) {}
+    template<class DATA>
+    static void apply(DATA* /*data*/, const SETS& /*sets*/) {}
+};
+
+/** Return the ids of the records matching the conditions when any record is held in the memory table (cache) */
+template<typename TABLE, typename... Args>
+std::vector<int> cached_ids_by(TABLE* table, wxSQLite3Database* db, bool op_and, const wxString& where, const Args&... args)
+{
+    std::vector<int> ids;
+    if (table->cache_.empty()) return ids;
+
+    wxString query = "SELECT " + TABLE::PRIMARY::name() + " FROM " + table->name();
+    if (!where.empty()) query += " WHERE " + where;
+    wxSQLite3Statement& stmt = table->statement(db, query, op_and, query);
+    bind(stmt, 1, args...);
+
+    wxSQLite3ResultSet q = stmt.ExecuteQuery();
+    while(q.NextRow())
+    {
+        int id = q.GetInt(0);
+        if (table->index_by_id_.find(id)) ids.push_back(id);
+    }
+    stmt.Reset();
+
+    return ids;
+}
+
+/**
+* Assign the SETS to every record matching the conditions with a single UPDATE,
+* then patch the matching records held in the memory table (cache).
+* Returns the number of records changed.
+*/
+template<typename TABLE, typename... SETS, typename... Args>
+int update_by(TABLE* table, wxSQLite3Database* db, bool op_and, const std::tuple<SETS...>& sets, const Args&... args)
+{
+    typedef DB_Assignments<sizeof...(SETS), std::tuple<SETS...> > Assignments;
+    if (db->IsReadOnly()) return 0;
+
+    int changes = 0;
+    wxString where;
+    condition(where, op_and, args...);
+    wxString query = "UPDATE " + table->name() + " SET ";
+    Assignments::sql(query);
+    if (!where.empty()) query += " WHERE " + where;
+    try
+    {
+        const std::vector<int> ids = cached_ids_by(table, db, op_and, where, args...);
+
+        wxSQLite3Statement& stmt = table->statement(db, query, op_and, query);
+        Assignments::bind(stmt, sets);
+        bind(stmt, 1 + sizeof...(SETS), args...);
+        changes = stmt.ExecuteUpdate();
+        stmt.Reset();
+        ++ table->revision_;
+
+        for (int id : ids)
+        {
+            typename TABLE::Data* entity = table->index_by_id_.find(id);
+            Assignments::apply(entity, sets);
+            table->index(entity);
+            table->cache_resize(entity);
+        }
+    }
+    catch(const wxSQLite3Exception &e)
+    {
+        table->forget_statement(db, query, op_and);
+        wxLogError("%s: Exception %s", table->name().c_str(), e.GetMessage().c_str());
+    }
+
+    return changes;
+}
+
+/**
+* Delete every record matching the conditions with a single DELETE,
+* then drop the matching records from the memory table (cache).
+* Returns the number of records deleted.
+*/
+template<typename TABLE, typename... Args>
+int remove_by(TABLE* table, wxSQLite3Database* db, bool op_and, const Args&... args)
+{
+    if (db->IsReadOnly()) return 0;
+
+    int changes = 0;
+    wxString where;
+    condition(where, op_and, args...);
+    wxString query = "DELETE FROM " + table->name();
+    if (!where.empty()) query += " WHERE " + where;
+    try
+    {
+        const std::vector<int> ids = cached_ids_by(table, db, op_and, where, args...);
+
+        wxSQLite3Statement& stmt = table->statement(db, query, op_and, query);
+        bind(stmt, 1, args...);
+        changes = stmt.ExecuteUpdate();
+        stmt.Reset();
+        ++ table->revision_;
+
+        for (int id : ids)
+        {
+            typename TABLE::Data* entity = table->index_by_id_.find(id);
+            table->unindex(entity);
+            table->cache_erase(entity);
+            table->arena_.destroy(entity);
+        }
+    }
+    catch(const wxSQLite3Exception &e)
+    {
+        table->forget_statement(db, query, op_and);
+        wxLogError("%s: Exception %s", table->name().c_str(), e.GetMessage().c_str());
+    }
+
+    return changes;
+}
+
 template<class DATA, typename Arg1>
 bool match(const DATA* data, const Arg1& arg1)
 {
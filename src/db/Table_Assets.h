@@ -42,9 +42,11 @@ struct DB_Table_ASSETS : public DB_Table
 
     /** A container to hold a list of Data record pointers for the table in memory*/
     typedef std::vector<Self::Data*> Cache;
-    typedef std::map<int, Self::Data*> Index_By_Id;
+    typedef DB_Index_By_Id<Self::Data> Index_By_Id;
     Cache cache_;
     Index_By_Id index_by_id_;
+    DB_Arena<Self::Data> arena_; // storage of the records in cache_
+    size_t clock_hand_; // next record of cache_ examined by shrink()
     Data* fake_; // in case the entity not found
 
     /** Destructor: clears any data records stored in memory */
@@ -57,9 +59,98 @@ struct DB_Table_ASSETS : public DB_Table
     /** Removes all records stored in memory (cache) for the table*/
     void destroy_cache()
     {
-        std::for_each(cache_.begin(), cache_.end(), std::mem_fun(&Data::destroy));
+        arena_.clear(cache_);
         cache_.clear();
         index_by_id_.clear(); // no memory release since it just stores pointer and the according objects are in cache
+        cache_complete_ = false;
+        cache_bytes_ = 0;
+        clock_hand_ = 0;
+        ++ revision_;
+    }
+
+    /**
+    * Evict records from the memory table (cache) until it fits in cache_budget_, using the
+    * CLOCK policy: a record used since the last sweep gets a second chance. Pinned records
+    * and records not saved yet are kept. Callers must not hold Data pointers of the table
+    * across a call, other than pinned ones.
+    * Returns the number of records evicted.
+    */
+    size_t shrink()
+    {
+        if (cache_budget_ == 0) return 0;
+
+        size_t evicted = 0, skipped = 0; // two sweeps without eviction: nothing left to evict
+        while (cache_bytes_ > cache_budget_ && skipped < 2 * cache_.size())
+        {
+            if (clock_hand_ >= cache_.size()) clock_hand_ = 0;
+            Self::Data* entity = cache_[clock_hand_];
+            if (entity->referenced_ || entity->id() <= 0 || pinned(entity->id()))
+            {
+                entity->referenced_ = false;
+                ++ clock_hand_;
+                ++ skipped;
+                continue;
+            }
+
+            unindex(entity);
+            cache_erase(entity); // the last record moves under the hand
+            arena_.destroy(entity);
+            ++ evicted;
+            skipped = 0;
+        }
+
+        if (evicted > 0)
+        {
+            evict_ += evicted;
+            cache_complete_ = false;
+        }
+        return evicted;
+    }
+
+    /** Add the record to the in-memory indexes, or refresh its keys */
+    void index(Self::Data* entity)
+    {
+        index_by_id_.insert(entity->id(), entity);
+    }
+
+    /** Remove the record from the in-memory indexes */
+    void unindex(Self::Data* entity)
+    {
+        index_by_id_.erase(entity->id());
+    }
+
+    /** Add the record to the memory table (cache) */
+    void cache_insert(Self::Data* entity)
+    {
+        entity->cache_pos_ = cache_.size();
+        entity->referenced_ = true;
+        entity->bytes_ = entity->footprint();
+        cache_bytes_ += entity->bytes_;
+        cache_.push_back(entity);
+    }
+
+    /** Refresh the memory accounted for a cached record after its fields changed */
+    void cache_resize(Self::Data* entity)
+    {
+        cache_bytes_ -= entity->bytes_;
+        entity->bytes_ = entity->footprint();
+        cache_bytes_ += entity->bytes_;
+    }
+
+    /** Return true if the record is owned by the memory table (cache) */
+    bool cached(const Self::Data* entity) const
+    {
+        return entity->cache_pos_ < cache_.size() && cache_[entity->cache_pos_] == entity;
+    }
+
+    /** Unlink the record from the memory table (cache) in constant time */
+    void cache_erase(Self::Data* entity)
+    {
+        cache_bytes_ -= entity->bytes_;
+        Self::Data* last = cache_.back();
+        cache_[entity->cache_pos_] = last;
+        last->cache_pos_ = entity->cache_pos_;
+        cache_.pop_back();
     }
 
     /** Creates the database table if the table does not exist*/
@@ -207,6 +298,12 @@ struct DB_Table_ASSETS : public DB_Table
         friend struct DB_Table_ASSETS;
         /** This is a instance pointer to itself in memory. */
         Self* table_;
+        /** Position in the memory table (cache), see cached() */
+        size_t cache_pos_;
+        /** Used since the last sweep of shrink() */
+        bool referenced_;
+        /** Memory accounted in cache_bytes_, see footprint() */
+        size_t bytes_;
 
         int ASSETID; // primary key
         wxString STARTDATE;
@@ -216,6 +313,7 @@ struct DB_Table_ASSETS : public DB_Table
         wxString NOTES;
         double VALUECHANGERATE;
         wxString ASSETTYPE;
+        DB_Date STARTDATE_YMD; // STARTDATE decoded on load and save
 
         int id() const
         {
@@ -240,6 +338,9 @@ struct DB_Table_ASSETS : public DB_Table
         explicit Data(Self* table = 0)
         {
             table_ = table;
+            cache_pos_ = 0;
+            referenced_ = false;
+            bytes_ = 0;
 
             ASSETID = -1;
             VALUE = 0.0;
@@ -249,7 +350,15 @@ struct DB_Table_ASSETS : public DB_Table
         explicit Data(wxSQLite3ResultSet& q, Self* table = 0)
         {
             table_ = table;
+            cache_pos_ = 0;
+            referenced_ = false;
+            bytes_ = 0;
+            load(q);
+        }
 
+        /** Load the fields from the current row of the result set */
+        void load(wxSQLite3ResultSet& q)
+        {
             ASSETID = q.GetInt(0);
             STARTDATE = q.GetString(1);
             ASSETNAME = q.GetString(2);
@@ -258,6 +367,7 @@ struct DB_Table_ASSETS : public DB_Table
             NOTES = q.GetString(5);
             VALUECHANGERATE = q.GetDouble(6);
             ASSETTYPE = q.GetString(7);
+            STARTDATE_YMD = DB_Date(STARTDATE);
         }
 
         Data& operator=(const Data& other)
@@ -272,9 +382,21 @@ struct DB_Table_ASSETS : public DB_Table
             NOTES = other.NOTES;
             VALUECHANGERATE = other.VALUECHANGERATE;
             ASSETTYPE = other.ASSETTYPE;
+            STARTDATE_YMD = other.STARTDATE_YMD;
             return *this;
         }
 
+        /** Approximate memory held by the record, including its text fields */
+        size_t footprint() const
+        {
+            return sizeof(*this)
+                + STARTDATE.Len() * sizeof(wxChar)
+                + ASSETNAME.Len() * sizeof(wxChar)
+                + VALUECHANGE.Len() * sizeof(wxChar)
+                + NOTES.Len() * sizeof(wxChar)
+                + ASSETTYPE.Len() * sizeof(wxChar);
+        }
+
 
         bool match(const Self::ASSETID &in) const
         {
@@ -316,6 +438,47 @@ struct DB_Table_ASSETS : public DB_Table
             return this->ASSETTYPE.CmpNoCase(in.v_) == 0;
         }
 
+        void assign(const Self::ASSETID &in)
+        {
+            this->ASSETID = in.v_;
+        }
+
+        void assign(const Self::STARTDATE &in)
+        {
+            this->STARTDATE = in.v_;
+            this->STARTDATE_YMD = DB_Date(in.v_);
+        }
+
+        void assign(const Self::ASSETNAME &in)
+        {
+            this->ASSETNAME = in.v_;
+        }
+
+        void assign(const Self::VALUE &in)
+        {
+            this->VALUE = in.v_;
+        }
+
+        void assign(const Self::VALUECHANGE &in)
+        {
+            this->VALUECHANGE = in.v_;
+        }
+
+        void assign(const Self::NOTES &in)
+        {
+            this->NOTES = in.v_;
+        }
+
+        void assign(const Self::VALUECHANGERATE &in)
+        {
+            this->VALUECHANGERATE = in.v_;
+        }
+
+        void assign(const Self::ASSETTYPE &in)
+        {
+            this->ASSETTYPE = in.v_;
+        }
+
         /** Return the data record as a json string */
         wxString to_json() const
         {
@@ -400,11 +563,6 @@ struct DB_Table_ASSETS : public DB_Table
 
             return table_->remove(this, db);
         }
-
-        void destroy()
-        {
-            delete this;
-        }
     };
 
     enum
@@ -417,7 +575,7 @@ struct DB_Table_ASSETS : public DB_Table
     /** Name of the table */
     wxString name() const { return "ASSETS"; }
 
-    DB_Table_ASSETS() : fake_(new Data())
+    DB_Table_ASSETS() : clock_hand_(0), fake_(new Data())
     {
         query_ = "SELECT ASSETID, STARTDATE, ASSETNAME, VALUE, VALUECHANGE, NOTES, VALUECHANGERATE, ASSETTYPE FROM ASSETS ";
     }
@@ -425,8 +583,8 @@ struct DB_Table_ASSETS : public DB_Table
     /** Create a new Data record and add to memory table (cache) */
     Self::Data* create()
     {
-        Self::Data* entity = new Self::Data(this);
-        cache_.push_back(entity);
+        Self::Data* entity = arena_.create(this);
+        cache_insert(entity);
         return entity;
     }
 
@@ -439,6 +597,54 @@ struct DB_Table_ASSETS : public DB_Table
         return entity;
     }
 
+    /** Return the cached INSERT statement for a new record or UPDATE statement for an existing one */
+    wxSQLite3Statement& save_statement(wxSQLite3Database* db, bool insert)
+    {
+        if (insert)
+            return this->statement(db, "INSERT", true, "INSERT INTO ASSETS(STARTDATE, ASSETNAME, VALUE, VALUECHANGE, NOTES, VALUECHANGERATE, ASSETTYPE) VALUES(?, ?, ?, ?, ?, ?, ?)");
+        return this->statement(db, "UPDATE", true, "UPDATE ASSETS SET STARTDATE = ?, ASSETNAME = ?, VALUE = ?, VALUECHANGE = ?, NOTES = ?, VALUECHANGERATE = ?, ASSETTYPE = ? WHERE ASSETID = ?");
+    }
+
+    /** Bind the fields of the Data record to the statement returned by save_statement() */
+    static void bind_fields(wxSQLite3Statement& stmt, const Self::Data* entity)
+    {
+        stmt.Bind(1, entity->STARTDATE);
+        stmt.Bind(2, entity->ASSETNAME);
+        stmt.Bind(3, entity->VALUE);
+        stmt.Bind(4, entity->VALUECHANGE);
+        stmt.Bind(5, entity->NOTES);
+        stmt.Bind(6, entity->VALUECHANGERATE);
+        stmt.Bind(7, entity->ASSETTYPE);
+        if (entity->id() > 0)
+            stmt.Bind(8, entity->ASSETID);
+    }
+
+    /** Assign the id of an inserted record, and refresh the memory table (cache) */
+    void saved(Self::Data* entity, wxSQLite3Database* db, bool inserted)
+    {
+        entity->STARTDATE_YMD = DB_Date(entity->STARTDATE);
+        ++ revision_;
+        if (inserted)
+        {
+            entity->id((db->GetLastRowId()).ToLong());
+            if (cached(entity)) // records outside the cache, e.g. in a Data_Set, are not indexed
+            {
+                index(entity);
+                cache_resize(entity);
+            }
+        }
+        else
+        {
+            Self::Data* e = index_by_id_.find(entity->id());
+            if (e)
+            {
+                if (e != entity) *e = *entity;  // in-place update
+                index(e);
+                cache_resize(e);
+            }
+        }
+    }
+
     /**
     * Saves the Data record to the database table.
     * Either create a new record or update the existing record.
@@ -446,55 +652,65 @@ struct DB_Table_ASSETS : public DB_Table
     */
     bool save(Self::Data* entity, wxSQLite3Database* db)
     {
-        wxString sql = wxEmptyString;
-        if (entity->id() <= 0) //  new & insert
+        const bool insert = entity->id() <= 0;
+        try
         {
-            sql = "INSERT INTO ASSETS(STARTDATE, ASSETNAME, VALUE, VALUECHANGE, NOTES, VALUECHANGERATE, ASSETTYPE) VALUES(?, ?, ?, ?, ?, ?, ?)";
+            wxSQLite3Statement& stmt = save_statement(db, insert);
+            bind_fields(stmt, entity);
+            stmt.ExecuteUpdate();
+            stmt.Reset();
         }
-        else
+        catch(const wxSQLite3Exception &e)
         {
-            sql = "UPDATE ASSETS SET STARTDATE = ?, ASSETNAME = ?, VALUE = ?, VALUECHANGE = ?, NOTES = ?, VALUECHANGERATE = ?, ASSETTYPE = ? WHERE ASSETID = ?";
+            this->forget_statement(db, insert ? "INSERT" : "UPDATE", true);
+            wxLogError("ASSETS: Exception %s, %s", e.GetMessage().c_str(), entity->to_json());
+            return false;
         }
 
+        saved(entity, db, insert);
+        return true;
+    }
+
+    /**
+    * Saves the Data records to the database table in one pass, binding each record to
+    * the same prepared INSERT or UPDATE statement. The caller wraps it in a transaction.
+    * Returns the number of records saved; stops at the first failure.
+    */
+    size_t save(std::vector<Self::Data*>& entities, wxSQLite3Database* db)
+    {
+        if (entities.empty() || db->IsReadOnly()) return 0;
+
+        wxStopWatch sw;
+        size_t count = 0;
+        wxSQLite3Statement* insert_stmt = 0;
+        wxSQLite3Statement* update_stmt = 0;
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
-
-            stmt.Bind(1, entity->STARTDATE);
-            stmt.Bind(2, entity->ASSETNAME);
-            stmt.Bind(3, entity->VALUE);
-            stmt.Bind(4, entity->VALUECHANGE);
-            stmt.Bind(5, entity->NOTES);
-            stmt.Bind(6, entity->VALUECHANGERATE);
-            stmt.Bind(7, entity->ASSETTYPE);
-            if (entity->id() > 0)
-                stmt.Bind(8, entity->ASSETID);
+            for (auto entity : entities)
+            {
+                const bool insert = entity->id() <= 0;
+                wxSQLite3Statement*& stmt = insert ? insert_stmt : update_stmt;
+                if (!stmt) stmt = &save_statement(db, insert);
 
-            stmt.ExecuteUpdate();
-            stmt.Finalize();
+                bind_fields(*stmt, entity);
+                stmt->ExecuteUpdate();
+                stmt->Reset();
 
-            if (entity->id() > 0) // existent
-            {
-                for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
-                {
-                    Self::Data* e = *it;
-                    if (e->id() == entity->id())
-                        *e = *entity;  // in-place update
-                }
+                saved(entity, db, insert);
+                ++count;
             }
         }
         catch(const wxSQLite3Exception &e)
         {
-            wxLogError("ASSETS: Exception %s, %s", e.GetMessage().c_str(), entity->to_json());
-            return false;
+            this->forget_statement(db, "INSERT", true);
+            this->forget_statement(db, "UPDATE", true);
+            wxLogError("ASSETS: Exception %s, %s", e.GetMessage().c_str(), entities[count]->to_json());
         }
 
-        if (entity->id() <= 0)
-        {
-            entity->id((db->GetLastRowId()).ToLong());
-            index_by_id_.insert(std::make_pair(entity->id(), entity));
-        }
-        return true;
+        const long ms = sw.Time();
+        wxLogDebug("ASSETS: %zu records saved in %ld ms (%.0f records/s)", count, ms
+            , ms > 0 ? count * 1000.0 / ms : static_cast<double>(count));
+        return count;
     }
 
     /** Remove the Data record from the database and the memory table (cache) */
@@ -504,30 +720,23 @@ struct DB_Table_ASSETS : public DB_Table
         try
         {
             wxString sql = "DELETE FROM ASSETS WHERE ASSETID = ?";
-            wxSQLite3Statement stmt = db->PrepareStatement(sql);
+            wxSQLite3Statement& stmt = this->statement(db, "DELETE", true, sql);
             stmt.Bind(1, id);
             stmt.ExecuteUpdate();
-            stmt.Finalize();
+            stmt.Reset();
+            ++ revision_;
 
-            Cache c;
-            for(Cache::iterator it = cache_.begin(); it != cache_.end(); ++ it)
+            Self::Data* entity = index_by_id_.find(id);
+            if (entity)
             {
-                Self::Data* entity = *it;
-                if (entity->id() == id)
-                {
-                    index_by_id_.erase(entity->id());
-                    delete entity;
-                }
-                else
-                {
-                    c.push_back(entity);
-                }
+                unindex(entity);
+                cache_erase(entity);
+                arena_.destroy(entity);
             }
-            cache_.clear();
-            cache_.swap(c);
         }
         catch(const wxSQLite3Exception &e)
         {
+            this->forget_statement(db, "DELETE", true);
             wxLogError("ASSETS: Exception %s", e.GetMessage().c_str());
             return false;
         }
@@ -538,9 +747,10 @@ struct DB_Table_ASSETS : public DB_Table
     /** Remove the Data record from the database and the memory table (cache) */
     bool remove(Self::Data* entity, wxSQLite3Database* db)
     {
+        const bool indexed = (index_by_id_.find(entity->id()) == entity);
         if (remove(entity->id(), db))
         {
-            entity->id(-1);
+            if (!indexed) entity->id(-1); // the indexed record has been released
             return true;
         }
 
@@ -550,14 +760,12 @@ struct DB_Table_ASSETS : public DB_Table
     template<typename... Args>
     Self::Data* get_one(const Args& ... args)
     {
-        for (Index_By_Id::iterator it = index_by_id_.begin(); it != index_by_id_.end(); ++ it)
+        Self::Data* item = index_by_id_.find_if([&](const Self::Data* d) { return d->id() > 0 && match(d, args...); });
+        if (item)
         {
-            Self::Data* item = it->second;
-            if (item->id() > 0 && match(item, args...))
-            {
-                ++ hit_;
-                return item;
-            }
+            ++ hit_;
+            item->referenced_ = true;
+            return item;
         }
 
         ++ miss_;
@@ -577,32 +785,35 @@ struct DB_Table_ASSETS : public DB_Table
             return 0;
         }
 
-        Index_By_Id::iterator it = index_by_id_.find(id);
-        if (it != index_by_id_.end())
+        Self::Data* cached_entity = index_by_id_.find(id);
+        if (cached_entity)
         {
             ++ hit_;
-            return it->second;
+            cached_entity->referenced_ = true;
+            return cached_entity;
         }
 
         ++ miss_;
         Self::Data* entity = 0;
-        wxString where = wxString::Format(" WHERE %s = ?", PRIMARY::name().c_str());
+        wxString where;
+        condition(where, true, PRIMARY(id)); // same shape as find(PRIMARY(id))
         try
         {
-            wxSQLite3Statement stmt = db->PrepareStatement(this->query() + where);
+            wxSQLite3Statement& stmt = this->statement(db, where, true, this->query() + " WHERE " + where);
             stmt.Bind(1, id);
 
             wxSQLite3ResultSet q = stmt.ExecuteQuery();
             if(q.NextRow())
             {
-                entity = new Self::Data(q, this);
-                cache_.push_back(entity);
-                index_by_id_.insert(std::make_pair(id, entity));
+                entity = arena_.create(q, this);
+                cache_insert(entity);
+                index(entity);
             }
-            stmt.Finalize();
+            stmt.Reset();
         }
         catch(const wxSQLite3Exception &e)
         {
+            this->forget_statement(db, where, true);
             wxLogError("%s: Exception %s", this->name().c_str(), e.GetMessage().c_str());
         }
 
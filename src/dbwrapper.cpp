@@ -18,6 +18,7 @@
 
 #include "dbwrapper.h"
 #include "util.h"
+#include "Table.h"
 #include <wx/msgdlg.h>
 #include <wx/wxsqlite3.h>
 #include <sqlite3.h> // for SQLITE_OK etc.
@@ -66,6 +67,7 @@ wxSharedPtr<wxSQLite3Database> mmDBWrapper::Open(const wxString &dbpath, const w
     {
         // wrong file extension maybe? try emb<->mmb
         wxASSERT(db->IsOpen());
+        DB_Statement_Cache::instance().reset(db.get());
         db->Close();
         err = SQLITE_OK;
         errStr = wxEmptyString;
@@ -100,6 +102,7 @@ wxSharedPtr<wxSQLite3Database> mmDBWrapper::Open(const wxString &dbpath, const w
     wxMessageDialog msgDlg(nullptr, s, _("Opening MMEX Database - Error"), wxOK | wxICON_ERROR);
     msgDlg.ShowModal();
 
+    DB_Statement_Cache::instance().reset(db.get());
     if (db->IsOpen()) db->Close();
     db.reset();
     return db; // return a NULL database pointer
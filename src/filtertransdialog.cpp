@@ -634,8 +634,8 @@ bool mmFilterTransactionsDialog::allowType(const wxString& typeState, bool sameA
     return result;
 }
 
-template<class MODEL, class FULL_DATA>
-bool mmFilterTransactionsDialog::checkAmount(const FULL_DATA& tran)
+template<class DATA, class SPLITS>
+bool mmFilterTransactionsDialog::checkAmount(const DATA& tran, const SPLITS& splits)
 {
     bool ok = true, split_ok = false;
     if (!amountMinEdit_->IsEmpty() && m_min_amount > tran.TRANSAMOUNT)
@@ -643,9 +643,9 @@ bool mmFilterTransactionsDialog::checkAmount(const FULL_DATA& tran)
     else if (!amountMaxEdit_->IsEmpty() && m_max_amount < tran.TRANSAMOUNT)
         ok = false;
 
-    if (tran.has_split())
+    if (!splits.empty())
     {
-        for (const auto s : tran.m_splits)
+        for (const auto& s : splits)
         {
             if ((amountMinEdit_->IsEmpty() || m_min_amount <= s.SPLITTRANSAMOUNT)
                 && (amountMaxEdit_->IsEmpty() || m_max_amount >= s.SPLITTRANSAMOUNT))
@@ -708,8 +708,8 @@ void mmFilterTransactionsDialog::OnPayeeUpdated(wxCommandEvent& event)
     event.Skip();
 }
 
-template<class MODEL, class FULL_DATA>
-bool mmFilterTransactionsDialog::checkPayee(const FULL_DATA &tran)
+template<class DATA>
+bool mmFilterTransactionsDialog::checkPayee(const DATA &tran)
 {
     const Model_Payee::Data* payee = Model_Payee::instance().get(tran.PAYEEID);
     if (payee)
@@ -717,10 +717,10 @@ bool mmFilterTransactionsDialog::checkPayee(const FULL_DATA &tran)
     return false;
 }
 
-template<class MODEL, class FULL_DATA>
-bool mmFilterTransactionsDialog::checkCategory(const FULL_DATA& tran)
+template<class DATA, class SPLITS>
+bool mmFilterTransactionsDialog::checkCategory(const DATA& tran, const SPLITS& splits)
 {
-    if (!tran.has_split())
+    if (splits.empty())
     {
         if (categID_ != tran.CATEGID) return false;
         if (subcategID_ != tran.SUBCATEGID && !bSimilarCategoryStatus_) return false;
@@ -728,7 +728,7 @@ bool mmFilterTransactionsDialog::checkCategory(const FULL_DATA& tran)
     else
     {
         bool bMatching = false;
-        for (const auto &split : tran.m_splits)
+        for (const auto &split : splits)
         {
             if (split.CATEGID != categID_) continue;
             if (split.SUBCATEGID != subcategID_ && !bSimilarCategoryStatus_) continue;
@@ -741,23 +741,31 @@ bool mmFilterTransactionsDialog::checkCategory(const FULL_DATA& tran)
     return true;
 }
 
-bool mmFilterTransactionsDialog::checkAll(const Model_Checking::Full_Data &tran, int accountID)
+bool mmFilterTransactionsDialog::checkAll(const Model_Checking::Row &row)
 {
+    const Model_Checking::Data* record = row.data();
+    return record && checkAll(*record, row);
+}
+
+bool mmFilterTransactionsDialog::checkAll(const Model_Checking::Data &tran, const Model_Checking::Row &row)
+{
+    const auto splits = row.splits();
+
     bool ok = true;
     //wxLogDebug("Check date? %i trx date:%s %s %s", getDateRangeCheckBox(), tran.TRANSDATE, getFromDateCtrl().GetDateOnly().FormatISODate(), getToDateControl().GetDateOnly().FormatISODate());
     if (getAccountCheckBox() && (getAccountID() != tran.ACCOUNTID && getAccountID() != tran.TOACCOUNTID))
         ok = false;
     else if (getDateRangeCheckBox() && !(tran.TRANSDATE >= m_begin_date && tran.TRANSDATE <= m_end_date))
         ok = false;
-    else if (getPayeeCheckBox() && !checkPayee<Model_Checking>(tran))
+    else if (getPayeeCheckBox() && !checkPayee(tran))
         ok = false;
-    else if (getCategoryCheckBox() && !checkCategory<Model_Checking>(tran))
+    else if (getCategoryCheckBox() && !checkCategory(tran, splits))
         ok = false;
-    else if (getStatusCheckBox() && !compareStatus(tran.STATUSFD, m_filterStatus))
+    else if (getStatusCheckBox() && !compareStatus(Model_Checking::account_status(tran, row.account_id), m_filterStatus))
         ok = false;
-    else if (getTypeCheckBox() && !allowType(tran.TRANSCODE, accountID == tran.ACCOUNTID))
+    else if (getTypeCheckBox() && !allowType(tran.TRANSCODE, row.account_id == tran.ACCOUNTID))
         ok = false;
-    else if (getAmountRangeCheckBox() && !checkAmount<Model_Checking>(tran))
+    else if (getAmountRangeCheckBox() && !checkAmount(tran, splits))
         ok = false;
     else if (getNumberCheckBox() && (getNumber().empty()
         ? !tran.TRANSACTIONNUMBER.empty()
@@ -767,7 +775,7 @@ bool mmFilterTransactionsDialog::checkAll(const Model_Checking::Full_Data &tran,
         ? !tran.NOTES.empty()
         : tran.NOTES.empty() || !tran.NOTES.Lower().Matches(getNotes().Lower())))
         ok = false;
-    else if (m_custom_fields->IsSomeWidgetChanged() && !m_custom_fields->IsDataFound(tran))
+    else if (m_custom_fields->IsSomeWidgetChanged() && !m_custom_fields->IsDataFound(row))
         ok = false;
     return ok;
 }
@@ -778,15 +786,15 @@ bool mmFilterTransactionsDialog::checkAll(const Model_Billsdeposits::Full_Data &
         ok = false;
     else if (getDateRangeCheckBox() && (tran.TRANSDATE < m_begin_date && tran.TRANSDATE > m_end_date))
         ok = false;
-    else if (getPayeeCheckBox() && !checkPayee<Model_Billsdeposits>(tran))
+    else if (getPayeeCheckBox() && !checkPayee(tran))
         ok = false;
-    else if (getCategoryCheckBox() && !checkCategory<Model_Billsdeposits>(tran))
+    else if (getCategoryCheckBox() && !checkCategory(tran, tran.m_splits))
         ok = false;
     else if (getStatusCheckBox() && !compareStatus(tran.STATUS, m_filterStatus))
         ok = false;
     else if (getTypeCheckBox() && !allowType(tran.TRANSCODE, true))
         ok = false;
-    else if (getAmountRangeCheckBox() && !checkAmount<Model_Billsdeposits>(tran))
+    else if (getAmountRangeCheckBox() && !checkAmount(tran, tran.m_splits))
         ok = false;
     else if (getNumberCheckBox() && (getNumber().empty()
         ? !tran.TRANSACTIONNUMBER.empty()
@@ -49,7 +49,10 @@ public:
 
     virtual int ShowModal();
 
-    bool checkAll(const Model_Checking::Full_Data &tran, int accountID);
+    /// Returns true if the transaction as seen from the account of the row passes the filter.
+    bool checkAll(const Model_Checking::Row &row);
+    /** As above with the record of the row already in hand */
+    bool checkAll(const Model_Checking::Data &tran, const Model_Checking::Row &row);
     bool checkAll(const Model_Billsdeposits::Full_Data &tran);
     void getDescription(mmHTMLBuilder &hb);
     bool SomethingSelected();
@@ -71,12 +74,12 @@ private:
     bool getDateRangeCheckBox();
     bool getAmountRangeCheckBox();
 
-    template<class MODEL, class FULL_DATA = typename MODEL::Full_Data>
-    bool checkPayee(const FULL_DATA &tran);
-    template<class MODEL, class FULL_DATA = typename MODEL::Full_Data>
-    bool checkCategory(const FULL_DATA &tran);
-    template<class MODEL, class FULL_DATA = typename MODEL::Full_Data>
-    bool checkAmount(const FULL_DATA &tran);
+    template<class DATA>
+    bool checkPayee(const DATA &tran);
+    template<class DATA, class SPLITS>
+    bool checkCategory(const DATA &tran, const SPLITS &splits);
+    template<class DATA, class SPLITS>
+    bool checkAmount(const DATA &tran, const SPLITS &splits);
 
     wxString getNumber();
     wxString getNotes();
@@ -382,33 +382,32 @@ void mmQIFExportDialog::mmExportQIF()
         wxProgressDialog progressDlg(_("Please wait"), _("Exporting")
             , 100, this, wxPD_APP_MODAL | wxPD_CAN_ABORT);
 
-        const auto splits = Model_Splittransaction::instance().get_all();
+        const auto& splits = Model_Splittransaction::instance().get_all();
 
         const wxString begin_date = fromDateCtrl_->GetValue().FormatISODate();
         const wxString end_date = toDateCtrl_->GetValue().FormatISODate();
+        const std::vector<int> account_ids(selected_accounts_id_.begin(), selected_accounts_id_.end());
 
 
-        for (const auto& transaction : Model_Checking::instance().find(
-            Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)
-        ))
+        Model_Checking::instance().for_each([&](const Model_Checking::Data& transaction) -> bool
         {
             //Filtering
             if (dateFromCheckBox_->IsChecked() && transaction.TRANSDATE < begin_date)
-                continue;
+                return true;
             if (dateToCheckBox_->IsChecked() && transaction.TRANSDATE > end_date)
-                continue;
+                return true;
             if (!Model_Checking::is_transfer(transaction.TRANSCODE)
                 && (selected_accounts_id_.Index(transaction.ACCOUNTID) == wxNOT_FOUND))
-                continue;
+                return true;
             if (Model_Checking::is_transfer(transaction.TRANSCODE)
                 && (selected_accounts_id_.Index(transaction.ACCOUNTID) == wxNOT_FOUND)
                 && (selected_accounts_id_.Index(transaction.TOACCOUNTID) == wxNOT_FOUND))
-                continue;
+                return true;
             //
 
             // if Cancel clicked
             if (!progressDlg.Pulse(wxString::Format(_("Exporting transaction %zu"), ++numRecords)))
-                break; // abort processing
+                return false; // abort processing
 
             wxString trx_str;
             Model_Checking::Full_Data full_tran(0, transaction, splits);
@@ -433,7 +432,9 @@ void mmQIFExportDialog::mmExportQIF()
             trx_str = mmExportTransaction::getTransactionQIF(full_tran, dateMask, reverce);
             allAccounts4Export[accID] += trx_str;
 
-        }
+            return true;
+        }, Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)
+            , ANY_OF(IN_LIST<Model_Checking::ACCOUNTID>(account_ids), IN_LIST<Model_Checking::TOACCOUNTID>(account_ids)));
 
         //Export accounts
         for (const auto &entry : allAccounts4Export)
@@ -1039,7 +1039,7 @@ void mmUnivCSVDialog::OnExport(wxCommandEvent& WXUNUSED(event))
     if (!from_account)
         return;
 
-    const auto split = Model_Splittransaction::instance().get_all();
+    const auto& split = Model_Splittransaction::instance().get_all();
     int fromAccountID = from_account->ACCOUNTID;
 
     wxDateTime trx_date;
@@ -1238,7 +1238,7 @@ void mmUnivCSVDialog::update_preview()
 
         if (from_account)
         {
-            const auto split = Model_Splittransaction::instance().get_all();
+            const auto& split = Model_Splittransaction::instance().get_all();
             int fromAccountID = from_account->ACCOUNTID;
             size_t count = 0;
             int row = 0;
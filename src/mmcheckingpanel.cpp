@@ -32,6 +32,7 @@
 #include "Model_Usage.h"
 #include "Model_Setting.h"
 #include "Model_Infotable.h"
+#include "Model_Ledger.h"
 #include "paths.h"
 #include "sharetransactiondialog.h"
 #include "splittransactionsdialog.h"
@@ -148,24 +149,74 @@ bool mmCheckingPanel::Create(
     return true;
 }
 
+/* The record of the row, an empty one once the transaction is removed */
+static const Model_Checking::Data& record(const Model_Checking::Row& row)
+{
+    static const Model_Checking::Data removed;
+    const Model_Checking::Data* r = row.data();
+    return r ? *r : removed;
+}
+
+/* The notes of the row as shown, after the attachment sign when the transaction has some */
+static wxString notes(const Model_Checking::Row& row)
+{
+    wxString notes = record(row).NOTES;
+    if (Model_Attachment::instance().count(Model_Attachment::TRANSACTION, row.TRANSID))
+        notes.Prepend(mmAttachmentManage::GetAttachmentNoteSign());
+    return notes;
+}
+
+/*
+    Sort the rows on a key computed once per row: the keys are looked up in the models,
+    the rows only hold the TRANSID, AMOUNT and BALANCE.
+*/
+template<class KEY, class LESS>
+static void sortRows(Model_Checking::Row_Set& rows, KEY key, LESS less)
+{
+    typedef decltype(key(rows.front())) Key;
+    std::vector<std::pair<Key, size_t> > keys;
+    keys.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+        keys.push_back(std::make_pair(key(rows[i]), i));
+    std::stable_sort(keys.begin(), keys.end()
+        , [&less](const std::pair<Key, size_t>& x, const std::pair<Key, size_t>& y) { return less(x.first, y.first); });
+
+    Model_Checking::Row_Set sorted;
+    sorted.reserve(rows.size());
+    for (const auto& k : keys)
+        sorted.push_back(rows[k.second]);
+    rows.swap(sorted);
+}
+
+template<class KEY>
+static void sortRows(Model_Checking::Row_Set& rows, KEY key)
+{
+    sortRows(rows, key, std::less<decltype(key(rows.front()))>());
+}
+
 void mmCheckingPanel::sortTable()
 {
+    typedef const Model_Checking::Row& Row;
     switch (m_listCtrlAccount->g_sortcol)
     {
     case TransactionListCtrl::COL_ID:
         std::stable_sort(this->m_trans.begin(), this->m_trans.end(),SorterByTRANSID());
         break;
     case TransactionListCtrl::COL_NUMBER:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), Model_Checking::SorterByNUMBER());
+        sortRows(this->m_trans, [](Row r) { return record(r).TRANSACTIONNUMBER; }
+            , [](const wxString& x, const wxString& y)
+            {
+                return x.IsNumber() && y.IsNumber() ? (wxAtoi(x) < wxAtoi(y)) : x < y;
+            });
         break;
     case TransactionListCtrl::COL_PAYEE_STR:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByPAYEENAME());
+        sortRows(this->m_trans, [](Row r) { return r.payee_name(); });
         break;
     case TransactionListCtrl::COL_STATUS:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterBySTATUS());
+        sortRows(this->m_trans, [](Row r) { return record(r).STATUS; });
         break;
     case TransactionListCtrl::COL_CATEGORY:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByCATEGNAME());
+        sortRows(this->m_trans, [](Row r) { return r.category_name(); });
         break;
     case TransactionListCtrl::COL_WITHDRAWAL:
         std::stable_sort(this->m_trans.begin(), this->m_trans.end(), Model_Checking::SorterByWITHDRAWAL());
@@ -177,25 +228,25 @@ void mmCheckingPanel::sortTable()
         std::stable_sort(this->m_trans.begin(), this->m_trans.end(), Model_Checking::SorterByBALANCE());
         break;
     case TransactionListCtrl::COL_NOTES:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByNOTES());
+        sortRows(this->m_trans, [](Row r) { return notes(r); });
         break;
     case TransactionListCtrl::COL_DATE:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByTRANSDATE());
+        sortRows(this->m_trans, [](Row r) { return record(r).TRANSDATE; });
         break;
     case TransactionListCtrl::COL_UDFC01:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByUDFC01);
+        sortRows(this->m_trans, [](Row r) { return r.udfc(0); });
         break;
     case TransactionListCtrl::COL_UDFC02:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByUDFC02);
+        sortRows(this->m_trans, [](Row r) { return r.udfc(1); });
         break;
     case TransactionListCtrl::COL_UDFC03:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByUDFC03);
+        sortRows(this->m_trans, [](Row r) { return r.udfc(2); });
         break;
     case TransactionListCtrl::COL_UDFC04:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByUDFC04);
+        sortRows(this->m_trans, [](Row r) { return r.udfc(3); });
         break;
     case TransactionListCtrl::COL_UDFC05:
-        std::stable_sort(this->m_trans.begin(), this->m_trans.end(), SorterByUDFC05);
+        sortRows(this->m_trans, [](Row r) { return r.udfc(4); });
         break;
     case TransactionListCtrl::COL_IMGSTATUS: break;
     case TransactionListCtrl::COL_MAX: break;
@@ -213,30 +264,23 @@ void mmCheckingPanel::filterTable()
     m_reconciled_balance = m_account_balance;
     m_filteredBalance = 0.0;
 
-    const auto custom_fields = Model_CustomFieldData::instance().get_all(Model_Attachment::TRANSACTION);
-    const auto matrix = Model_CustomField::getMatrix(Model_Attachment::TRANSACTION);
-    int udfc01_ref_id = matrix.at("UDFC01");
-    int udfc02_ref_id = matrix.at("UDFC02");
-    int udfc03_ref_id = matrix.at("UDFC03");
-    int udfc04_ref_id = matrix.at("UDFC04");
-    int udfc05_ref_id = matrix.at("UDFC05");
-
-    const auto splits = Model_Splittransaction::instance().get_all();
-    const auto attachments = Model_Attachment::instance().get_all(Model_Attachment::TRANSACTION);
     for (const auto& tran : Model_Account::transaction(this->m_account))
     {
+        // the rows look their record up by id, keep the one in hand
+        Model_Checking::instance().cache(tran);
         double transaction_amount = Model_Checking::amount(tran, m_AccountID);
-        Model_Checking::Full_Data full_tran(m_AccountID, tran, splits);
+        const Model_Checking::STATUS_ENUM status = Model_Checking::status(Model_Checking::account_status(tran, m_AccountID));
 
-        if (Model_Checking::status(full_tran.STATUSFD) != Model_Checking::VOID_)
+        if (status != Model_Checking::VOID_)
             m_account_balance += transaction_amount;
 
-        if (Model_Checking::status(full_tran.STATUSFD) == Model_Checking::RECONCILED)
+        if (status == Model_Checking::RECONCILED)
             m_reconciled_balance += transaction_amount;
 
+        const Model_Checking::Row row(m_AccountID, tran.TRANSID, transaction_amount, m_account_balance);
         if (m_transFilterActive)
         {
-            if (!m_trans_filter_dlg->checkAll(full_tran, m_AccountID))
+            if (!m_trans_filter_dlg->checkAll(tran, row))
                 continue;
         }
         else
@@ -248,38 +292,8 @@ void mmCheckingPanel::filterTable()
             }
         }
 
-        full_tran.PAYEENAME = full_tran.real_payee_name(m_AccountID);
-        full_tran.BALANCE = m_account_balance;
-        full_tran.AMOUNT = transaction_amount;
         m_filteredBalance += transaction_amount;
-
-        if (custom_fields.find(tran.TRANSID) != custom_fields.end()) {
-            const auto& udfcs = custom_fields.at(tran.TRANSID);
-            for (const auto& udfc : udfcs)
-            {
-                if (udfc.FIELDID == udfc01_ref_id) {
-                    full_tran.UDFC01 = udfc.CONTENT;
-                }
-                else if (udfc.FIELDID == udfc02_ref_id) {
-                    full_tran.UDFC02 = udfc.CONTENT;
-                }
-                else if (udfc.FIELDID == udfc03_ref_id) {
-                    full_tran.UDFC03 = udfc.CONTENT;
-                }
-                else if (udfc.FIELDID == udfc04_ref_id) {
-                    full_tran.UDFC04 = udfc.CONTENT;
-                }
-                else if (udfc.FIELDID == udfc05_ref_id) {
-                    full_tran.UDFC05 = udfc.CONTENT;
-                }
-            }
-        }
-
-        if (attachments.count(full_tran.TRANSID)) {
-            full_tran.NOTES.Prepend(mmAttachmentManage::GetAttachmentNoteSign());
-        }
-
-        this->m_trans.push_back(full_tran);
+        this->m_trans.push_back(row);
     }
 }
 
@@ -287,23 +301,21 @@ void mmCheckingPanel::updateTable()
 {
     m_account_balance = 0.0;
     m_reconciled_balance = 0.0;
+    // summed in minor units of the currency of the account, see Money
+    const int precision = m_account ? Model_Currency::precision(Model_Account::currency(m_account)) : 2;
     if (m_account)
     {
-        m_account_balance = m_account->INITIALBAL;
-        m_reconciled_balance = m_account_balance;
-    }
-    for (const auto& tran : m_trans /*Model_Account::transaction(m_account)*/)
-    {
-        double transaction_amount = Model_Checking::amount(tran, m_AccountID);
-        if (Model_Checking::status(tran.STATUSFD) != Model_Checking::VOID_)
-            m_account_balance += transaction_amount;
-        m_reconciled_balance += Model_Checking::reconciled(tran, m_AccountID);
+        const Money initial(m_account->INITIALBAL, precision);
+        m_account_balance = (initial + Model_Ledger::instance().sum(m_AccountID)).to_double(precision);
+        m_reconciled_balance = (initial
+            + Model_Ledger::instance().sum(m_AccountID, Model_Ledger::RECONCILED)).to_double(precision);
     }
-    m_filteredBalance = 0.0;
+    Money filtered;
     for (const auto & tran : m_trans)
     {
-        m_filteredBalance += Model_Checking::amount(tran, m_AccountID);
+        filtered += Money(tran.AMOUNT, precision);
     }
+    m_filteredBalance = filtered.to_double(precision);
 
     setAccountSummary();
 
@@ -348,7 +360,7 @@ void mmCheckingPanel::markSelectedTransaction(int trans_id)
             bool future = true;
             while (future && i >= 0)
             {
-                if (m_trans[i].TRANSDATE > m_listCtrlAccount->m_today && i > 0)
+                if (record(m_trans[i]).TRANSDATE > m_listCtrlAccount->m_today && i > 0)
                 {
                     i = m_listCtrlAccount->g_asc ? i - 1 : i + 1;
                 }
@@ -630,11 +642,11 @@ void mmCheckingPanel::updateExtraTransactionData(int selIndex)
     {
         enableEditDeleteButtons(true);
 
-        Model_Checking::Full_Data& full_tran = this->m_trans.at(selIndex);
-        m_info_panel->SetLabelText(full_tran.NOTES);
-        wxString miniStr = full_tran.info();
+        const Model_Checking::Row& row = this->m_trans.at(selIndex);
+        m_info_panel->SetLabelText(notes(row));
+        wxString miniStr = row.info();
 
-        if (Model_Checking::foreignTransaction(full_tran))
+        if (row.is_foreign())
         {
             m_btnDuplicate->Enable(false);
         }
@@ -831,7 +843,7 @@ void mmCheckingPanel::DeleteViewedTransactions()
     Model_Checking::instance().Savepoint();
     for (const auto& tran: this->m_trans)
     {
-        if (Model_Checking::foreignTransaction(tran))
+        if (tran.is_foreign())
         {
             Model_Translink::RemoveTranslinkEntry(tran.TRANSID);
         }
@@ -849,7 +861,7 @@ void mmCheckingPanel::DeleteFlaggedTransactions(const wxString& status)
     Model_Checking::instance().Savepoint();
     for (const auto& tran: this->m_trans)
     {
-        if (tran.STATUS == status)
+        if (record(tran).STATUS == status)
         {
             // remove also removes any split transactions
             Model_Checking::instance().remove(tran.TRANSID);
@@ -891,21 +903,21 @@ const wxString mmCheckingPanel::getItem(long item, long column)
 {
     if (item < 0 || static_cast<size_t>(item) >= m_trans.size()) return "";
 
-    const Model_Checking::Full_Data& tran = this->m_trans.at(item);
+    const Model_Checking::Row& tran = this->m_trans.at(item);
     switch (column)
     {
     case TransactionListCtrl::COL_ID:
         return wxString::Format("%i", tran.TRANSID).Trim();
     case TransactionListCtrl::COL_DATE:
-        return mmGetDateForDisplay(tran.TRANSDATE);
+        return mmGetDateForDisplay(record(tran).TRANSDATE);
     case TransactionListCtrl::COL_NUMBER:
-        return tran.TRANSACTIONNUMBER;
+        return record(tran).TRANSACTIONNUMBER;
     case TransactionListCtrl::COL_CATEGORY:
-        return tran.CATEGNAME;
+        return tran.category_name();
     case TransactionListCtrl::COL_PAYEE_STR:
-        return tran.is_foreign_transfer() ? "< " + tran.PAYEENAME : tran.PAYEENAME;
+        return tran.is_foreign_transfer() ? "< " + tran.payee_name() : tran.payee_name();
     case TransactionListCtrl::COL_STATUS:
-        return tran.is_foreign() ? "< " + tran.STATUSFD : tran.STATUSFD;
+        return tran.is_foreign() ? "< " + tran.status() : tran.status();
     case TransactionListCtrl::COL_WITHDRAWAL:
         return tran.AMOUNT <= 0 ? Model_Currency::toString(std::fabs(tran.AMOUNT), this->m_currency) : "";
     case TransactionListCtrl::COL_DEPOSIT:
@@ -913,17 +925,17 @@ const wxString mmCheckingPanel::getItem(long item, long column)
     case TransactionListCtrl::COL_BALANCE:
         return Model_Currency::toString(tran.BALANCE, this->m_currency);
     case TransactionListCtrl::COL_NOTES:
-        return tran.NOTES;
+        return notes(tran);
     case TransactionListCtrl::COL_UDFC01:
-        return tran.UDFC01;
+        return tran.udfc(0);
     case TransactionListCtrl::COL_UDFC02:
-        return tran.UDFC02;
+        return tran.udfc(1);
     case TransactionListCtrl::COL_UDFC03:
-        return tran.UDFC03;
+        return tran.udfc(2);
     case TransactionListCtrl::COL_UDFC04:
-        return tran.UDFC04;
+        return tran.udfc(3);
     case TransactionListCtrl::COL_UDFC05:
-        return tran.UDFC05;
+        return tran.udfc(4);
 
     default:
         return wxEmptyString;
@@ -1186,8 +1198,8 @@ void TransactionListCtrl::OnMouseRightClick(wxMouseEvent& event)
     bool is_foreign = false;
     if (m_selectedIndex > -1)
     {
-        const Model_Checking::Full_Data& tran = m_cp->m_trans.at(m_selectedIndex);
-        if (Model_Checking::type(tran.TRANSCODE) == Model_Checking::TRANSFER)
+        const Model_Checking::Row& tran = m_cp->m_trans.at(m_selectedIndex);
+        if (Model_Checking::type(record(tran).TRANSCODE) == Model_Checking::TRANSFER)
         {
             type_transfer = true;
         }
@@ -1195,7 +1207,7 @@ void TransactionListCtrl::OnMouseRightClick(wxMouseEvent& event)
         {
             have_category = true;
         }
-        if (Model_Checking::foreignTransaction(tran))
+        if (tran.is_foreign())
         {
             is_foreign = true;
         }
@@ -1298,12 +1310,12 @@ void TransactionListCtrl::OnMarkTransaction(wxCommandEvent& event)
     else if (evt == MENU_TREEPOPUP_MARKDUPLICATE)          status = "D";
     else { wxFAIL_MSG("unknown transaction status"); }
 
-    Model_Checking::Full_Data& trx = m_cp->m_trans[m_selectedIndex];
+    Model_Checking::Data* trx = Model_Checking::instance().get(m_cp->m_trans[m_selectedIndex].TRANSID);
+    if (!trx) return;
     TransactionStatus trx_status(trx);
     org_status = trx_status.Status(m_cp->m_AccountID);
-    trx_status.SetStatus(status, m_cp->m_AccountID, trx);
-    trx.STATUSFD = trx_status.Status(m_cp->m_AccountID);
-    Model_Checking::instance().save(&trx);
+    trx_status.SetStatus(status, m_cp->m_AccountID, *trx);
+    Model_Checking::instance().save(trx);
 
     bool bRefreshRequired = (status == "V") || (org_status == "V");
 
@@ -1360,14 +1372,16 @@ void TransactionListCtrl::OnMarkAllTransactions(wxCommandEvent& event)
     }
     else
     {
-        for (auto& trx : m_cp->m_trans)
+        Model_Checking::Data_Set trans;
+        trans.reserve(m_cp->m_trans.size());
+        for (const auto& row : m_cp->m_trans)
         {
-            trx.NOTES.Replace(mmAttachmentManage::GetAttachmentNoteSign(), wxEmptyString, true);
-            TransactionStatus trx_status(trx);
-            trx_status.SetStatus(status, m_cp->m_AccountID, trx);
-            trx.STATUSFD = trx_status.Status(m_cp->m_AccountID);
+            if (!row.data()) continue;
+            trans.push_back(record(row));
+            TransactionStatus trx_status(trans.back());
+            trx_status.SetStatus(status, m_cp->m_AccountID, trans.back());
         }
-        Model_Checking::instance().save(m_cp->m_trans);
+        Model_Checking::instance().save(trans);
     }
 
     refreshVisualList();
@@ -1458,7 +1472,7 @@ wxListItemAttr* TransactionListCtrl::OnGetItemAttr(long item) const
 {
     if (item < 0 || static_cast<size_t>(item) >= m_cp->m_trans.size()) return 0;
 
-    const Model_Checking::Full_Data& tran = m_cp->m_trans[item];
+    const Model_Checking::Data& tran = record(m_cp->m_trans[item]);
     bool in_the_future = (tran.TRANSDATE > m_today);
 
     // apply alternating background pattern
@@ -1643,7 +1657,7 @@ void TransactionListCtrl::OnListKeyDown(wxListEvent& event)
     m_topItemIndex = GetTopItem() + GetCountPerPage() - 1;
 
     //Read status of the selected transaction
-    wxString status = m_cp->m_trans[m_selectedIndex].STATUS;
+    wxString status = record(m_cp->m_trans[m_selectedIndex]).STATUS;
 
     if (wxGetKeyState(wxKeyCode('R')) && status != "R") {
         wxCommandEvent evt(wxEVT_COMMAND_MENU_SELECTED, MENU_TREEPOPUP_MARKRECONCILED);
@@ -1689,7 +1703,7 @@ void TransactionListCtrl::OnDeleteTransaction(wxCommandEvent& WXUNUSED(event))
 
     m_topItemIndex = GetTopItem() + GetCountPerPage() - 1;
 
-    Model_Checking::Data checking_entry = m_cp->m_trans[m_selectedIndex];
+    Model_Checking::Data checking_entry = record(m_cp->m_trans[m_selectedIndex]);
     if (TransactionLocked(checking_entry.TRANSDATE))
     {
         return;
@@ -1711,7 +1725,7 @@ void TransactionListCtrl::OnDeleteTransaction(wxCommandEvent& WXUNUSED(event))
             {
                 SetItemState(x, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
 
-                if (Model_Checking::foreignTransaction(i))
+                if (i.is_foreign())
                 {
                     Model_Translink::RemoveTranslinkEntry(transID);
                     m_cp->m_frame->RefreshNavigationTree();
@@ -1781,9 +1795,9 @@ void TransactionListCtrl::OnEditTransaction(wxCommandEvent& WXUNUSED(event))
         return;
     }
 
-    if (m_selectedIndex < 0) return;
+    if (m_selectedIndex < 0 || !m_cp->m_trans[m_selectedIndex].data()) return;
 
-    Model_Checking::Data checking_entry = m_cp->m_trans[m_selectedIndex];
+    Model_Checking::Data checking_entry = record(m_cp->m_trans[m_selectedIndex]);
     int transaction_id = checking_entry.TRANSID;
 
     if (TransactionLocked(checking_entry.TRANSDATE))
@@ -1857,7 +1871,6 @@ void TransactionListCtrl::OnSetUserColour(wxCommandEvent& event)
     {
         transaction->FOLLOWUPID = user_colour_id;
         Model_Checking::instance().save(transaction);
-        m_cp->m_trans[m_selectedIndex].FOLLOWUPID = user_colour_id;
         RefreshItems(m_selectedIndex, m_selectedIndex);
     }
 }
@@ -1908,7 +1921,7 @@ void TransactionListCtrl::OnMoveTransaction(wxCommandEvent& WXUNUSED(event))
 
     // Abort if any transaction is locked.
     for (long index : GetSelected()) {
-        Model_Checking::Data checking_entry = m_cp->m_trans[index];
+        const Model_Checking::Data& checking_entry = record(m_cp->m_trans[index]);
         if (TransactionLocked(checking_entry.TRANSDATE)){
             return;
         }
@@ -1934,10 +1947,10 @@ void TransactionListCtrl::OnMoveTransaction(wxCommandEvent& WXUNUSED(event))
             return;
 
         // Update all selected transactions, first grab all transactions as we want to modify multiple ones in sequence and indices can change.
-        std::vector<Model_Checking::Full_Data> transactions;
+        Model_Checking::Data_Set transactions;
         for (long index : GetSelected()) {
-            Model_Checking::Full_Data& tran = m_cp->m_trans[index];
-            transactions.push_back(tran);
+            if (!m_cp->m_trans[index].data()) continue;
+            transactions.push_back(record(m_cp->m_trans[index]));
         }
 
         // Save the modification
@@ -1954,7 +1967,7 @@ void TransactionListCtrl::OnMoveTransaction(wxCommandEvent& WXUNUSED(event))
 void TransactionListCtrl::OnViewSplitTransaction(wxCommandEvent& WXUNUSED(event))
 {
     if ((m_selectedIndex > -1) && (GetSelectedItemCount() == 1)) {
-        const Model_Checking::Full_Data& tran = m_cp->m_trans.at(m_selectedIndex);
+        const Model_Checking::Row& tran = m_cp->m_trans.at(m_selectedIndex);
         if (tran.has_split())
             m_cp->DisplaySplitCategories(tran.TRANSID);
     }
@@ -1980,7 +1993,7 @@ void TransactionListCtrl::OnCreateReoccurance(wxCommandEvent& WXUNUSED(event))
     if ((m_selectedIndex < 0) || (GetSelectedItemCount() > 1)) return;
 
     mmBDDialog dlg(this, 0, false, false);
-    dlg.SetDialogParameters(m_cp->m_trans[m_selectedIndex]);
+    dlg.SetDialogParameters(m_cp->m_trans[m_selectedIndex].full_data());
     if (dlg.ShowModal() == wxID_OK)
     {
         wxMessageBox(_("Reoccuring Transaction saved."));
@@ -2011,9 +2024,10 @@ void TransactionListCtrl::OnListItemFocused(wxListEvent& WXUNUSED(event))
     {
         if (GetItemState(x, wxLIST_STATE_SELECTED) == wxLIST_STATE_SELECTED)
         {
-            balance += Model_Checking::balance(i);
-            if (minDate > i.TRANSDATE || maxDate.empty()) minDate = i.TRANSDATE;
-            if (maxDate < i.TRANSDATE || maxDate.empty()) maxDate = i.TRANSDATE;
+            const Model_Checking::Data& tran = record(i);
+            balance += Model_Checking::balance(tran);
+            if (minDate > tran.TRANSDATE || maxDate.empty()) minDate = tran.TRANSDATE;
+            if (maxDate < tran.TRANSDATE || maxDate.empty()) maxDate = tran.TRANSDATE;
         }
         x++;
     }
@@ -579,9 +579,9 @@ void mmCustomData::SetWidgetChanged(wxWindowID id, const wxString& data)
     }
 }
 
-bool mmCustomData::IsDataFound(const Model_Checking::Full_Data &tran)
+bool mmCustomData::IsDataFound(const Model_Checking::Row &row)
 {
-    const auto& data_set = Model_CustomFieldData::instance().find(Model_CustomFieldData::REFID(tran.TRANSID));
+    const auto& data_set = Model_CustomFieldData::instance().find(Model_CustomFieldData::REFID(row.TRANSID));
     for (const auto& filter : m_data_changed)
     {
         for (const auto& item : data_set)
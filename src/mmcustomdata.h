@@ -70,7 +70,7 @@ public:
     void ResetRefID() { m_ref_id = -1; }
     // TODO: void SetRefID(int ref_id) { m_ref_id = ref_id; }
     bool IsSomeWidgetChanged() const;
-    bool IsDataFound(const Model_Checking::Full_Data &tran);
+    bool IsDataFound(const Model_Checking::Row &row);
     void ResetWidgetsChanged();
     void ClearSettings() const;
     bool IsCustomPanelShown() const;
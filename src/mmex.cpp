@@ -30,7 +30,11 @@
 #include <wx/cmdline.h>
 
 //----------------------------------------------------------------------------
+#ifdef MMEX_TESTS
+wxIMPLEMENT_APP_NO_MAIN(mmGUIApp); // the model tests have their own main()
+#else
 wxIMPLEMENT_APP(mmGUIApp);
+#endif
 //----------------------------------------------------------------------------
 
 static const wxCmdLineEntryDesc g_cmdLineDesc [] =
@@ -304,7 +308,12 @@ int mmGUIApp::OnExit()
     usage->JSONCONTENT = rj;
     Model_Usage::instance().save(usage);
 
-    if (m_setting_db) delete m_setting_db;
+    Model_Setting::instance().Flush();
+    if (m_setting_db)
+    {
+        DB_Statement_Cache::instance().reset(m_setting_db);
+        delete m_setting_db;
+    }
 
     /* CURL Cleanup */
     curl_global_cleanup();
@@ -181,6 +181,7 @@ EVT_MENU_RANGE(wxID_FILE1, wxID_FILE9, mmGUIFrame::OnRecentFiles)
 EVT_MENU(MENU_RECENT_FILES_CLEAR, mmGUIFrame::OnClearRecentFiles)
 EVT_MENU(MENU_VIEW_TOGGLE_FULLSCREEN, mmGUIFrame::OnToggleFullScreen)
 EVT_CLOSE(mmGUIFrame::OnClose)
+EVT_IDLE(mmGUIFrame::OnIdle)
 
 EVT_MENU_RANGE(MENU_TREEPOPUP_HIDE_SHOW_REPORT, MENU_TREEPOPUP_HIDE_SHOW_REPORT32, mmGUIFrame::OnHideShowReport)
 EVT_MENU_RANGE(MENU_LANG+1, MENU_LANG_MAX, mmGUIFrame::OnChangeGUILanguage)
@@ -346,7 +347,9 @@ void mmGUIFrame::ShutdownDatabase()
 {
     if (m_db)
     {
+        Model_Infotable::instance().Flush();
         m_db->SetCommitHook(nullptr);
+        DB_Statement_Cache::instance().reset(m_db.get());
         m_db->Close();
         delete m_commit_callback_hook;
         delete m_update_callback_hook;
@@ -1894,6 +1897,16 @@ void mmGUIFrame::InitializeModelTables()
     m_all_models.push_back(&Model_CustomField::instance(m_db.get()));
     m_all_models.push_back(&Model_Translink::instance(m_db.get()));
     m_all_models.push_back(&Model_Shareinfo::instance(m_db.get()));
+
+    // Tables growing with the history of the database may keep a bounded cache, see cleanupHomePanel().
+    // Unbounded (0) unless set: dialogs and reports still hold records they do not pin.
+    const size_t budget = static_cast<size_t>(Model_Setting::instance().GetIntSetting("CACHE_BUDGET_MB", 0)) << 20;
+    Model_Checking::instance().cache_budget(budget);
+    Model_Splittransaction::instance().cache_budget(budget);
+    Model_CurrencyHistory::instance().cache_budget(budget);
+    Model_StockHistory::instance().cache_budget(budget);
+    Model_Attachment::instance().cache_budget(budget);
+    Model_CustomFieldData::instance().cache_budget(budget);
 }
 
 bool mmGUIFrame::createDataStore(const wxString& fileName, const bool openingNew, const bool encrypt, const wxString& pwd)
@@ -2193,6 +2206,7 @@ void mmGUIFrame::OnSaveAs(wxCommandEvent& WXUNUSED(event))
     }
 
     // create backup database
+    Model_Infotable::instance().Flush();
     try {
         m_db->Backup(newFileName.GetFullPath(), password);
     }
@@ -3004,6 +3018,10 @@ wxSizer* mmGUIFrame::cleanupHomePanel(bool new_sizer)
         panelCurrent_ = nullptr;
     }
     homePanel_->DestroyChildren();
+
+    // No panel refers to cached records anymore; does nothing without a CACHE_BUDGET_MB
+    for (auto model : m_all_models)
+        model->shrink();
     homePanel_->SetSizer(new_sizer ? new wxBoxSizer(wxHORIZONTAL) : nullptr);
 
     return homePanel_->GetSizer();
@@ -3068,6 +3086,14 @@ void mmGUIFrame::OnClose(wxCloseEvent&)
     Destroy();
 }
 
+/** Write the settings and info values changed since the last idle time */
+void mmGUIFrame::OnIdle(wxIdleEvent& event)
+{
+    Model_Setting::instance().Flush();
+    if (m_db) Model_Infotable::instance().Flush();
+    event.Skip();
+}
+
 void mmGUIFrame::OnHideShowReport(wxCommandEvent& event)
 {
     int report = event.GetId() - MENU_TREEPOPUP_HIDE_SHOW_REPORT;
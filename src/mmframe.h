@@ -71,6 +71,7 @@ public:
     void menuPrintingEnable(bool enable);
     void OnToggleFullScreen(wxCommandEvent& WXUNUSED(event));
     void OnClose(wxCloseEvent&);
+    void OnIdle(wxIdleEvent& event);
     std::vector<WebsiteNews> g_WebsiteNewsList;
 
     void RefreshNavigationTree();
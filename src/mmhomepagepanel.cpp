@@ -33,6 +33,8 @@ Copyright (C) 2014 Nikolay
 #include "Model_Payee.h"
 #include "Model_Stock.h"
 #include "Model_Category.h"
+#include "Model_CategoryCube.h"
+#include "Model_CheckingColumns.h"
 #include "Model_Report.h"
 #include "Model_Infotable.h"
 #include "reports/mmDateRange.h"
@@ -230,48 +232,36 @@ void htmlWidgetTop7Categories::getTopCategoryStats(
     , const mmDateRange* date_range) const
 {
     //Temporary map
-    std::map<std::pair<int /*category*/, int /*sub category*/>, double> stat;
+    std::map<std::pair<int /*category*/, int /*sub category*/>, Money> stat;
 
-    const auto splits = Model_Splittransaction::instance().get_all();
-    const auto &transactions = Model_Checking::instance().find(
-            Model_Checking::TRANSDATE(date_range->start_date(), GREATER_OR_EQUAL)
-            , Model_Checking::TRANSDATE(date_range->end_date(), LESS_OR_EQUAL)
-            , Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)
-            , Model_Checking::TRANSCODE(Model_Checking::TRANSFER, NOT_EQUAL));
-
-    for (const auto &trx : transactions)
+    Model_CategoryCube& cube = Model_CategoryCube::instance();
+    cube.for_each(DB_Date(date_range->start_date()), DB_Date(date_range->end_date())
+        , [&stat](const Model_CategoryCube::Key& k, const Money& amount)
     {
-        bool withdrawal = Model_Checking::type(trx) == Model_Checking::WITHDRAWAL;
-        const auto it = splits.find(trx.TRANSID);
-        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(trx.ACCOUNTID)->CURRENCYID, trx.TRANSDATE);
-
-        if (it == splits.end())
-        {
-            std::pair<int, int> category = std::make_pair(trx.CATEGID, trx.SUBCATEGID);
-            if (withdrawal)
-                stat[category] -= trx.TRANSAMOUNT * convRate;
-            else
-                stat[category] += trx.TRANSAMOUNT * convRate;
-        }
-        else
+        std::pair<int, int> category = std::make_pair(k.categ, k.subcateg);
+        switch (k.type)
         {
-            for (const auto& entry : it->second)
-            {
-                std::pair<int, int> category = std::make_pair(entry.CATEGID, entry.SUBCATEGID);
-                double val = entry.SPLITTRANSAMOUNT * convRate * (withdrawal ? -1 : 1);
-                stat[category] += val;
-            }
+        case Model_CategoryCube::WITHDRAWAL:
+        case Model_CategoryCube::WITHDRAWAL_AS_TRANSFER:
+            stat[category] -= amount;
+            break;
+        case Model_CategoryCube::DEPOSIT:
+        case Model_CategoryCube::DEPOSIT_AS_TRANSFER:
+            stat[category] += amount;
+            break;
+        default:
+            break;
         }
-    }
+    });
 
     categoryStats.clear();
     for (const auto& i : stat)
     {
-        if (i.second < 0)
+        if (i.second < Money())
         {
             std::pair <wxString, double> stat_pair;
             stat_pair.first = Model_Category::full_name(i.first.first, i.first.second);
-            stat_pair.second = i.second;
+            stat_pair.second = i.second.to_double(cube.precision());
             categoryStats.push_back(stat_pair);
         }
     }
@@ -640,35 +630,19 @@ void mmHomePagePanel::fillData()
 
 void mmHomePagePanel::setAccountsData(std::map<int, std::pair<double, double> > &accountStats)
 {
-    Model_Checking::Data_Set all_trans;
+    Model_CheckingColumns::Filter filter;
     if (Option::instance().getIgnoreFutureTransactions())
-    {
-        all_trans = Model_Checking::instance().find(
-            DB_Table_CHECKINGACCOUNT::TRANSDATE(date_range_->today().FormatISODate(), LESS_OR_EQUAL));
-    }
-    else
-    {
-        all_trans = Model_Checking::instance().all();
-    }
+        filter.to_ymd = DB_Date(date_range_->today()).ymd();
+    this->total_transactions_ = Model_CheckingColumns::instance().count(filter);
 
-    this->total_transactions_ = all_trans.size();
-
-    for (const auto& trx : all_trans)
+    // Do not include asset or stock transfers in income expense calculations.
+    filter.as_transfer = false;
+    this->countFollowUp_ = 0;
+    for (const auto& account : Model_CheckingColumns::instance().by_account(filter))
     {
-        // Do not include asset or stock transfers in income expense calculations.
-        if (Model_Checking::foreignTransactionAsTransfer(trx))
-            continue;
-
-        if (Model_Checking::status(trx) == Model_Checking::FOLLOWUP) this->countFollowUp_++;
-
-        accountStats[trx.ACCOUNTID].first += Model_Checking::reconciled(trx, trx.ACCOUNTID);
-        accountStats[trx.ACCOUNTID].second += Model_Checking::balance(trx, trx.ACCOUNTID);
-
-        if (Model_Checking::type(trx) == Model_Checking::TRANSFER)
-        {
-            accountStats[trx.TOACCOUNTID].first += Model_Checking::reconciled(trx, trx.TOACCOUNTID);
-            accountStats[trx.TOACCOUNTID].second += Model_Checking::balance(trx, trx.TOACCOUNTID);
-        }
+        accountStats[account.first].first += account.second.reconciled;
+        accountStats[account.first].second += account.second.balance;
+        this->countFollowUp_ += account.second.followup;
     }
 }
 
@@ -686,11 +660,12 @@ void mmHomePagePanel::setExpensesIncomeStatsData(std::map<int, std::pair<double,
         , Model_Checking::TRANSCODE(Model_Checking::TRANSFER, NOT_EQUAL)
         );
 
+    const DB_Date today(date_range->today());
     for (const auto& pBankTransaction : transactions)
     {
         if (ignoreFuture)
         {
-            if (Model_Checking::TRANSDATE(pBankTransaction).IsLaterThan(date_range->today()))
+            if (pBankTransaction.TRANSDATE_YMD > today)
                 continue; //skip future dated transactions
         }
 
@@ -698,7 +673,7 @@ void mmHomePagePanel::setExpensesIncomeStatsData(std::map<int, std::pair<double,
         if (Model_Checking::foreignTransactionAsTransfer(pBankTransaction))
             continue;
 
-        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(pBankTransaction.ACCOUNTID)->CURRENCYID, pBankTransaction.TRANSDATE);
+        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(pBankTransaction.ACCOUNTID)->CURRENCYID, pBankTransaction.TRANSDATE_YMD);
 
         int idx = pBankTransaction.ACCOUNTID;
         if (Model_Checking::type(pBankTransaction) == Model_Checking::DEPOSIT)
@@ -32,22 +32,6 @@ class wxSQLite3ResultSet;
 
 typedef wxDateTime wxDate;
 
-#if (wxMAJOR_VERSION == 3 && wxMINOR_VERSION >= 1)
-    // wx 3.1 has implemented such hash
-#else
-namespace std
-{
-    template<>
-    struct hash<wxString>
-    {
-        size_t operator()(const wxString& k) const
-        {
-            return std::hash<std::wstring>()(k.ToStdWstring());
-        }
-    };
-}
-#endif
-
 class ModelBase
 {
 public:
@@ -71,19 +55,14 @@ public:
 protected:
     static wxDate to_date(const wxString& str_date)
     {
-        static std::unordered_map<wxString, wxDate> cache;
-        const auto it = cache.find(str_date);
-        if (it != cache.end()) return it->second;
-
-        wxDate date;
-        date.ParseISODate(str_date); // the date in ISO 8601 format "YYYY-MM-DD".
-        cache.insert(std::make_pair(str_date, date));
-        return date;
+        return DB_Date(str_date).to_date(); // the date in ISO 8601 format "YYYY-MM-DD".
     }
 
 public:
     virtual wxString  GetTableStatsAsJson() const = 0;
     virtual void show_statistics() const = 0;
+    virtual void cache_budget(size_t bytes) = 0;
+    virtual size_t shrink() = 0;
 
 protected:
     wxSQLite3Database* db_;
@@ -138,6 +117,44 @@ public:
         return find_by(this, db_, false, args...);
     }
 
+    template<typename... COLUMNS, typename... Args>
+    /**
+    Command: select<COLUMNS...>(const Args&... args)
+    COLUMNS: The table columns to read, e.g. Model_Checking::ACCOUNTID, Model_Checking::TRANSAMOUNT
+    Args: Zero or more Specialised Parameters creating SQL statement conditions used after the WHERE statement.
+    * Returns a list of tuples holding only the values of the projected columns.
+    */
+    const typename DB_Projection<COLUMNS...>::Row_Set select(const Args&... args)
+    {
+        return select_by<COLUMNS...>(this, db_, true, args...);
+    }
+
+    template<typename... COLUMNS, typename... Args>
+    /**
+    Command: select_or<COLUMNS...>(const Args&... args)
+    As select() with the conditions joined by OR.
+    */
+    const typename DB_Projection<COLUMNS...>::Row_Set select_or(const Args&... args)
+    {
+        return select_by<COLUMNS...>(this, db_, false, args...);
+    }
+
+    template<typename VISITOR, typename... Args>
+    /**
+    Command: for_each(visitor, const Args&... args)
+    Args: Zero or more Specialised Parameters creating SQL statement conditions used after the WHERE statement.
+    Example:
+    Model_Checking::instance().for_each([&](const Model_Checking::Data& trx) -> bool { total += trx.TRANSAMOUNT; return true; }
+        , Model_Checking::ACCOUNTID(1));
+    * Streams the records found to the visitor straight from the database, without
+    * building a Data_Set. The visitor returns false to stop the iteration.
+    * The record passed to the visitor is only valid during the call.
+    */
+    void for_each(VISITOR visitor, const Args&... args)
+    {
+        for_each_by(this, db_, true, visitor, args...);
+    }
+
     /**
     * Return the Data record pointer for the given ID
     * from either memory cache or the database.
@@ -161,26 +178,30 @@ public:
     template<class DATA>
     int save(std::vector<DATA>& rows)
     {
-        this->Savepoint();
+        std::vector<typename DB_TABLE::Data*> entities;
+        entities.reserve(rows.size());
         for (auto& r : rows)
         {
             if (r.id() < 0)
                 wxLogDebug("Incorrect function call to save %s", r.to_json().c_str());
-            this->save(&r);
+            entities.push_back(&r);
         }
-        this->ReleaseSavepoint();
 
-        return rows.size();
+        return this->save(entities);
     }
 
+    /**
+    * Save the records within a single savepoint, reusing one
+    * prepared INSERT and one prepared UPDATE statement.
+    */
     template<class DATA>
     int save(std::vector<DATA*>& rows)
     {
         this->Savepoint();
-        for (auto& r : rows) this->save(r);
+        const size_t count = DB_TABLE::save(rows, this->db_);
         this->ReleaseSavepoint();
 
-        return rows.size();
+        return count;
     }
 
     /** Remove the Data record instance from memory and the database. */
@@ -189,15 +210,87 @@ public:
         return this->remove(id, db_);
     }
 
+    template<class COLUMN, typename... Args>
+    /**
+    Command: update_where(SET<COLUMN>(value), const Args&... args)
+    Args: Zero or more Specialised Parameters creating SQL statement conditions used after the WHERE statement.
+    Example:
+    Model_Checking::instance().update_where(SET<Model_Checking::PAYEEID>(new_id), Model_Checking::PAYEEID(old_id));
+    * Updates all the matching records with a single statement and patches the cached ones.
+    * Returns the number of records changed.
+    */
+    int update_where(const SET<COLUMN>& set, const Args&... args)
+    {
+        return update_by(this, db_, true, std::make_tuple(set), args...);
+    }
+
+    template<class COLUMN1, class COLUMN2, typename... Args>
+    /** As update_where() above, assigning two columns */
+    int update_where(const SET<COLUMN1>& set1, const SET<COLUMN2>& set2, const Args&... args)
+    {
+        return update_by(this, db_, true, std::make_tuple(set1, set2), args...);
+    }
+
+    template<typename... Args>
+    /**
+    Command: remove_where(const Args&... args)
+    Deletes all the matching records with a single statement and drops the cached ones.
+    Unlike the remove() of the derived models, dependent records (splits, attachments ...) are left alone.
+    * Returns the number of records deleted.
+    */
+    int remove_where(const Args&... args)
+    {
+        return remove_by(this, db_, true, args...);
+    }
+
 public:
     void preload(int max_num = 1000)
     {
         int i = 0;
-        for (const auto & item : all())
+        const auto rows = all();
+        for (const auto & item : rows)
         {
             get(item.id());
             if (++i >= max_num) break;
         }
+        this->cache_complete_ = (rows.size() <= static_cast<size_t>(max_num));
+    }
+
+    /**
+    * Return the record held in memory with the id of r, holding a copy of r when there is none,
+    * so that the records of a find() are then looked up by id without a query each.
+    */
+    typename DB_TABLE::Data* cache(const typename DB_TABLE::Data& r)
+    {
+        if (r.id() <= 0) return 0;
+        typename DB_TABLE::Data* entity = this->index_by_id_.find(r.id());
+        if (entity) return entity;
+
+        entity = this->arena_.create(r);
+        this->cache_insert(entity);
+        this->index(entity);
+        return entity;
+    }
+
+    /** Return true when every record of the table is held in memory, so a cache miss is final */
+    bool cache_complete() const
+    {
+        return this->cache_complete_;
+    }
+
+    /** Set the memory allowed to the cached records, 0 for no limit. Enforced by shrink() */
+    void cache_budget(size_t bytes)
+    {
+        this->cache_budget_ = bytes;
+    }
+
+    /**
+    * Evict the least recently used cached records over the budget.
+    * Only call it where no unpinned Data pointer of the table is held, e.g. between panels.
+    */
+    size_t shrink()
+    {
+        return DB_TABLE::shrink();
     }
 
     // Return accomulated table stats as a json string
@@ -218,6 +311,16 @@ public:
         json_writer.Int(this->miss_);
         json_writer.Key("skip");
         json_writer.Int(this->skip_);
+        json_writer.Key("evict");
+        json_writer.Int(this->evict_);
+        json_writer.Key("stmt_hit");
+        json_writer.Int(this->stmt_hit_);
+        json_writer.Key("stmt_miss");
+        json_writer.Int(this->stmt_miss_);
+        json_writer.Key("arena_bytes");
+        json_writer.Uint64(this->arena_.bytes());
+        json_writer.Key("cache_bytes");
+        json_writer.Uint64(this->cache_bytes_);
         json_writer.EndObject();
 
         wxLogDebug("======== Model.h : GetTableStatsAsJson =======");
@@ -229,10 +332,12 @@ public:
     /** Show table statistics*/
     void show_statistics() const
     {
-        wxLogDebug("%s : (cache %zu, index_by_id %zu, hit %zu, miss %zu, skip %zu)",
+        wxLogDebug("%s : (cache %zu, index_by_id %zu, hit %zu, miss %zu, skip %zu, evict %zu, stmt_hit %zu, stmt_miss %zu, arena_bytes %zu, cache_bytes %zu)",
             this->name(),
             this->cache_.size(),
             this->index_by_id_.size(),
-            this->hit_, this->miss_, this->skip_);
+            this->hit_, this->miss_, this->skip_, this->evict_,
+            this->stmt_hit_, this->stmt_miss_,
+            this->arena_.bytes(), this->cache_bytes_);
     }
 };
@@ -20,6 +20,7 @@
 #include "Model_Stock.h"
 #include "Model_Translink.h"
 #include "Model_Shareinfo.h"
+#include "Model_Ledger.h"
 
 const std::vector<std::pair<Model_Account::STATUS_ENUM, wxString> > Model_Account::STATUS_CHOICES =
 {
@@ -111,7 +112,7 @@ wxArrayString Model_Account::all_type()
 Model_Account::Data* Model_Account::get(const wxString& name)
 {
     Data* account = this->get_one(ACCOUNTNAME(name));
-    if (account) return account;
+    if (account || this->cache_complete()) return account;
 
     Data_Set items = this->find(ACCOUNTNAME(name));
     if (!items.empty()) account = this->get(items[0].ACCOUNTID, this->db_);
@@ -138,6 +139,17 @@ wxString Model_Account::get_account_name(int account_id)
         return _("Account Error");
 }
 
+const std::vector<int> Model_Account::account_ids(const wxArrayString& account_names)
+{
+    std::vector<int> ids;
+    for (const auto& name : account_names)
+    {
+        Data* account = instance().get(name);
+        if (account) ids.push_back(account->ACCOUNTID);
+    }
+    return ids;
+}
+
 /** Remove the Data record instance from memory and the database. */
 bool Model_Account::remove(int id)
 {
@@ -184,12 +196,9 @@ Model_Currency::Data* Model_Account::currency(const Data& r)
 
 const Model_Checking::Data_Set Model_Account::transaction(const Data*r)
 {
-    auto trans = Model_Checking::instance().find_or(Model_Checking::ACCOUNTID(r->ACCOUNTID)
-        , Model_Checking::TOACCOUNTID(r->ACCOUNTID));
-    std::sort(trans.begin(), trans.end());
-    std::stable_sort(trans.begin(), trans.end(), SorterByTRANSDATE());
-
-    return trans;
+    return Model_Checking::instance().find_or(Model_Checking::ACCOUNTID(r->ACCOUNTID)
+        , Model_Checking::TOACCOUNTID(r->ACCOUNTID)
+        , ORDER_BY<DB_Table_CHECKINGACCOUNT::TRANSDATE>(), ORDER_BY<Model_Checking::TRANSID>());
 }
 
 const Model_Checking::Data_Set Model_Account::transaction(const Data& r)
@@ -209,12 +218,8 @@ const Model_Billsdeposits::Data_Set Model_Account::billsdeposits(const Data& r)
 
 double Model_Account::balance(const Data* r)
 {
-    double sum = r->INITIALBAL;
-    for (const auto& tran: transaction(r))
-    {
-        sum += Model_Checking::balance(tran, r->ACCOUNTID);
-    }
-    return sum;
+    const int precision = Model_Currency::precision(currency(r));
+    return (Money(r->INITIALBAL, precision) + Model_Ledger::instance().sum(r->ACCOUNTID)).to_double(precision);
 }
 
 double Model_Account::balance(const Data& r)
@@ -65,6 +65,9 @@ public:
 
     static wxString get_account_name(int account_id);
 
+    /** Return the ids of the named accounts, for IN_LIST<ACCOUNTID> conditions */
+    static const std::vector<int> account_ids(const wxArrayString& account_names);
+
     /** Remove the Data record from memory and the database. */
     bool remove(int id);
 
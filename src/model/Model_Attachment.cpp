@@ -31,6 +31,8 @@ const std::vector<std::pair<Model_Attachment::REFTYPE, wxString> > Model_Attachm
 
 Model_Attachment::Model_Attachment()
     : Model<DB_Table_ATTACHMENT>()
+    , counts_loaded_(false)
+    , counts_revision_(0)
 {
 }
 
@@ -48,6 +50,8 @@ Model_Attachment& Model_Attachment::instance(wxSQLite3Database* db)
     ins.db_ = db;
     ins.destroy_cache();
     ins.ensure(db);
+    ins.counts_.clear();
+    ins.counts_loaded_ = false;
 
     return ins;
 }
@@ -85,7 +89,10 @@ const Model_Attachment::Data_Set Model_Attachment::FilterAttachments(const wxStr
 /** Return the number of attachments linked to a specific object */
 int Model_Attachment::NrAttachments(const wxString& RefType, const int RefId)
 {
-    return Model_Attachment::instance().find(Model_Attachment::DB_Table_ATTACHMENT::REFTYPE(RefType), Model_Attachment::REFID(RefId)).size();
+    const int type = reftype(RefType);
+    if (type < 0)
+        return Model_Attachment::instance().find(Model_Attachment::DB_Table_ATTACHMENT::REFTYPE(RefType), Model_Attachment::REFID(RefId)).size();
+    return Model_Attachment::instance().count(static_cast<REFTYPE>(type), RefId);
 }
 
 /** Return the last attachment number linked to a specific object */
@@ -141,3 +148,87 @@ wxArrayString Model_Attachment::allDescriptions()
     }
     return descriptions;
 }
+
+int Model_Attachment::count(REFTYPE reftype, int RefId)
+{
+    counts_sync(0);
+    if (!counts_loaded_)
+    {
+        counts_.assign(REFTYPE_CHOICES.size(), std::vector<int>());
+        this->for_each([this](const Data& r) -> bool
+            {
+                const int type = Model_Attachment::reftype(r.REFTYPE);
+                if (type < 0 || r.REFID < 0) return true;
+                std::vector<int>& counts = counts_[type];
+                if (counts.size() <= static_cast<size_t>(r.REFID)) counts.resize(r.REFID + 1, 0);
+                ++counts[r.REFID];
+                return true;
+            });
+        counts_loaded_ = true;
+    }
+
+    const std::vector<int>& counts = counts_[reftype];
+    return RefId >= 0 && static_cast<size_t>(RefId) < counts.size() ? counts[RefId] : 0;
+}
+
+int Model_Attachment::save(Data* r)
+{
+    const bool inserted = r->id() <= 0;
+    Model<DB_Table_ATTACHMENT>::save(r);
+
+    // an updated attachment may have moved, its former object is not known
+    if (counts_sync(1) && inserted)
+    {
+        const int type = reftype(r->REFTYPE);
+        if (type >= 0 && r->REFID >= 0)
+        {
+            std::vector<int>& counts = counts_[type];
+            if (counts.size() <= static_cast<size_t>(r->REFID)) counts.resize(r->REFID + 1, 0);
+            ++counts[r->REFID];
+        }
+    }
+    else if (!inserted)
+        counts_loaded_ = false;
+
+    return r->id();
+}
+
+bool Model_Attachment::remove(int id)
+{
+    const Data* r = this->get(id);
+    const int type = r ? reftype(r->REFTYPE) : -1;
+    const int ref_id = r ? r->REFID : -1;
+
+    const bool removed = Model<DB_Table_ATTACHMENT>::remove(id);
+    if (counts_sync(1) && type >= 0 && ref_id >= 0)
+    {
+        std::vector<int>& counts = counts_[type];
+        if (static_cast<size_t>(ref_id) < counts.size() && counts[ref_id] > 0) --counts[ref_id];
+    }
+    return removed;
+}
+
+/** Return the REFTYPE of the description, -1 when unknown */
+int Model_Attachment::reftype(const wxString& RefType)
+{
+    for (const auto& item : REFTYPE_CHOICES)
+    {
+        if (item.second == RefType) return item.first;
+    }
+    return -1;
+}
+
+/**
+* Check the counts against the revision of the table, expecting the given number of
+* changes made through save() or remove(). Anything else drops the counts.
+* Return true when the counts are to be patched.
+*/
+bool Model_Attachment::counts_sync(size_t changes)
+{
+    if (this->revision_ == counts_revision_) return false;
+
+    const bool patch = counts_loaded_ && (this->revision_ == counts_revision_ + changes);
+    if (!patch) counts_loaded_ = false;
+    counts_revision_ = this->revision_;
+    return patch;
+}
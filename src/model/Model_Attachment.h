@@ -26,6 +26,8 @@ class Model_Attachment : public Model<DB_Table_ATTACHMENT>
 {
 public:
     using Model<DB_Table_ATTACHMENT>::get;
+    using Model<DB_Table_ATTACHMENT>::save;
+    using Model<DB_Table_ATTACHMENT>::remove;
     enum REFTYPE { TRANSACTION = 0, STOCK, ASSET, BANKACCOUNT, BILLSDEPOSIT, PAYEE};
 
     static const std::vector<std::pair<REFTYPE, wxString> > REFTYPE_CHOICES;
@@ -70,6 +72,22 @@ public:
 
     /** Return all attachments descriptions*/
     wxArrayString allDescriptions();
+
+    /** Return the number of attachments linked to a specific object, without querying the database */
+    int count(REFTYPE reftype, int RefId);
+
+    /** Save the attachment and count it for its object */
+    int save(Data* r);
+    /** Remove the attachment and uncount it */
+    bool remove(int id);
+
+private:
+    static int reftype(const wxString& RefType);
+    bool counts_sync(size_t changes);
+
+    std::vector<std::vector<int> > counts_; // per REFTYPE, the number of attachments indexed by REFID
+    bool counts_loaded_;
+    size_t counts_revision_; // revision of the table the counts are up to date with
 };
 
 #endif
@@ -17,15 +17,20 @@
  ********************************************************/
 
 #include "Model_Category.h"
+#include "Model_CategoryCube.h"
 #include "Model_Checking.h"
 #include "Model_Billsdeposits.h"
 #include "Model_Account.h"
 #include "Model_CurrencyHistory.h"
 #include "reports/mmDateRange.h"
+#include <algorithm>
+#include <set>
+#include <thread>
 #include <tuple>
 
 Model_Category::Model_Category(): Model<DB_Table_CATEGORY>()
 {
+    tree_revision_[0] = tree_revision_[1] = 0;
 }
 
 Model_Category::~Model_Category()
@@ -43,6 +48,7 @@ Model_Category& Model_Category::instance(wxSQLite3Database* db)
     ins.ensure(db);
     ins.destroy_cache();
     ins.preload();
+    ins.tree_.reset();
 
     return ins;
 }
@@ -56,7 +62,7 @@ Model_Category& Model_Category::instance()
 Model_Category::Data* Model_Category::get(const wxString& name)
 {
     Data* category = this->get_one(CATEGNAME(name));
-    if (category) return category;
+    if (category || this->cache_complete()) return category;
 
     Data_Set items = this->find(CATEGNAME(name));
     if (!items.empty()) category = this->get(items[0].CATEGID, this->db_);
@@ -66,26 +72,30 @@ Model_Category::Data* Model_Category::get(const wxString& name)
 const std::map<wxString, std::pair<int, int> > Model_Category::all_categories()
 {
     std::map<wxString, std::pair<int, int> > full_categs;
-    for (const auto& c : instance().all(COL_CATEGNAME))
-    {
-        full_categs[c.CATEGNAME] = std::make_pair(c.CATEGID, -1);
-        for (const auto& s : Model_Subcategory::instance().find(Model_Subcategory::CATEGID(c.CATEGID)))
-        {
-            const wxString nameStr = instance().full_name(c.CATEGID, s.SUBCATEGID);
-            full_categs[nameStr] = std::make_pair(c.CATEGID, s.SUBCATEGID);
-        }
-    }
+    const Tree& tree = instance().tree();
+    for (size_t i = 0; i < tree.size(); ++i)
+        full_categs[tree[i].full_name] = std::make_pair(tree[i].CATEGID, tree[i].SUBCATEGID);
     return full_categs;
 }
 
 Model_Subcategory::Data_Set Model_Category::sub_category(const Data* r)
 {
-    return Model_Subcategory::instance().find(Model_Subcategory::CATEGID(r->CATEGID));
+    Model_Subcategory::Data_Set subcategories;
+    const Tree& tree = instance().tree();
+    const int i = tree.index(r->CATEGID);
+    if (i < 0) return subcategories;
+
+    for (int j = i + 1; j <= i + tree[i].children; ++j)
+    {
+        const Model_Subcategory::Data* sub_category = Model_Subcategory::instance().get(tree[j].SUBCATEGID);
+        if (sub_category) subcategories.push_back(*sub_category);
+    }
+    return subcategories;
 }
 
 Model_Subcategory::Data_Set Model_Category::sub_category(const Data& r)
 {
-    return Model_Subcategory::instance().find(Model_Subcategory::CATEGID(r.CATEGID));
+    return sub_category(&r);
 }
 
 const wxString Model_Category::full_name(const Data* category, const Model_Subcategory::Data* sub_category)
@@ -99,11 +109,61 @@ const wxString Model_Category::full_name(const Data* category, const Model_Subca
 
 const wxString Model_Category::full_name(const int category_id, const int subcategory_id)
 {
+    const Tree& tree = instance().tree();
+    const int i = tree.index(category_id, subcategory_id);
+    if (i >= 0) return tree[i].full_name;
+
     Data* category = Model_Category::instance().get(category_id);
     Model_Subcategory::Data* sub_category = Model_Subcategory::instance().get(subcategory_id);
     return full_name(category, sub_category);
 }
 
+const Model_Category::Tree& Model_Category::tree()
+{
+    const size_t revision[2] = { this->revision_, Model_Subcategory::instance().revision_ };
+    if (tree_ && revision[0] == tree_revision_[0] && revision[1] == tree_revision_[1])
+        return *tree_;
+
+    std::shared_ptr<Tree> tree = std::make_shared<Tree>();
+    std::map<int /*CATEGID*/, Model_Subcategory::Data_Set> subcategories;
+    for (const auto& s : Model_Subcategory::instance().all(Model_Subcategory::COL_SUBCATEGNAME))
+        subcategories[s.CATEGID].push_back(s);
+
+    for (const auto& c : this->all(COL_CATEGNAME))
+    {
+        const int parent = tree->nodes_.size();
+        const Model_Subcategory::Data_Set& subs = subcategories[c.CATEGID];
+        Tree::Node category = { c.CATEGID, -1, -1, static_cast<int>(subs.size()), c.CATEGNAME };
+        tree->nodes_.push_back(category);
+        tree->categories_[c.CATEGID] = parent;
+
+        for (const auto& s : subs)
+        {
+            Tree::Node sub_category = { c.CATEGID, s.SUBCATEGID, parent, 0, full_name(&c, &s) };
+            tree->subcategories_[s.SUBCATEGID] = tree->nodes_.size();
+            tree->nodes_.push_back(sub_category);
+        }
+    }
+
+    tree_ = tree;
+    tree_revision_[0] = revision[0];
+    tree_revision_[1] = revision[1];
+    return *tree_;
+}
+
+int Model_Category::Tree::index(int category_id, int subcategory_id) const
+{
+    if (subcategory_id < 0)
+    {
+        const auto it = categories_.find(category_id);
+        return it == categories_.end() ? -1 : it->second;
+    }
+
+    const auto it = subcategories_.find(subcategory_id);
+    if (it == subcategories_.end() || nodes_[it->second].CATEGID != category_id) return -1;
+    return it->second;
+}
+
 bool Model_Category::is_used(int id, int sub_id)
 {
     const auto &trans = Model_Checking::instance().find(Model_Checking::CATEGID(id), Model_Checking::SUBCATEGID(sub_id));
@@ -121,7 +181,7 @@ bool Model_Category::is_used(int id, int sub_id)
 bool Model_Category::has_income(int id, int sub_id)
 {
     double sum = 0.0;
-    auto splits = Model_Splittransaction::instance().get_all();
+    const auto& splits = Model_Splittransaction::instance().get_all();
     for (const auto& tran: Model_Checking::instance().find(Model_Checking::CATEGID(id), Model_Checking::SUBCATEGID(sub_id)))
     {
         switch (Model_Checking::type(tran))
@@ -156,81 +216,138 @@ bool Model_Category::has_income(int id, int sub_id)
 }
 
 void Model_Category::getCategoryStats(
-        std::map<int, std::map<int, std::map<int, double> > > &categoryStats
+        Stats &categoryStats
         , const wxArrayString* accountArray
         , mmDateRange* date_range, bool WXUNUSED(ignoreFuture) //TODO: deprecated
         , bool group_by_month
         , std::map<int, std::map<int, double> > *budgetAmt)
 {
     //Initialization
-    //Set std::map with zerros
-    const auto &allSubcategories = Model_Subcategory::instance().all();
-    double value = 0;
-    int columns = group_by_month ? 12 : 1;
-    const wxDateTime start_date(1, date_range->end_date().GetMonth(), date_range->end_date().GetYear());
-    for (const auto& category: Model_Category::instance().all())
+    //Column m is the month m months before the one of the end date
+    const Tree& tree = instance().tree();
+    const int columns = group_by_month ? 12 : 1;
+    const DB_Date end(date_range->end_date());
+    const int end_month = end.year() * 12 + end.month() - 1;
+    categoryStats.tree_ = instance().tree_;
+    categoryStats.keys_.resize(columns);
+    for (int m = 0; m < columns; m++)
     {
-        for (int m = 0; m < columns; m++)
-        {
-            const wxDateTime d = start_date.Subtract(wxDateSpan::Months(m));
-            int idx = group_by_month ? (d.GetYear()*100 + d.GetMonth()) : 0;
-            categoryStats[category.CATEGID][-1][idx] = value;
-            for (const auto & sub_category : allSubcategories)
-            {
-                if (sub_category.CATEGID == category.CATEGID)
-                    categoryStats[category.CATEGID][sub_category.SUBCATEGID][idx] = value;
-            }
-        }
+        const int month = end_month - m;
+        categoryStats.keys_[m] = group_by_month ? (month / 12) * 100 + month % 12 : 0;
     }
-    //Calculations
-    auto splits = Model_Splittransaction::instance().get_all();
-    for (const auto& transaction: Model_Checking::instance().find(
-        Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(date_range->end_date(), LESS_OR_EQUAL)))
+    const size_t size = tree.size() * columns;
+    categoryStats.values_.assign(size, 0.0);
+
+    std::set<int> accounts;
+    if (accountArray)
+    {
+        for (const auto& id : Model_Account::account_ids(*accountArray))
+            accounts.insert(id);
+    }
+    auto negative_budget = [budgetAmt](int categ, int subcateg) -> bool
     {
+        const auto c = budgetAmt->find(categ);
+        if (c == budgetAmt->end()) return false;
+        const auto s = c->second.find(subcateg);
+        return s != c->second.end() && s->second < 0;
+    };
 
-        if (accountArray)
-        {
-            const auto account = Model_Account::instance().get(transaction.ACCOUNTID);
-            if (wxNOT_FOUND == accountArray->Index(account->ACCOUNTNAME)) {
-                continue;
-            }
-        }
+    //Calculations
+    //The months are shared out between the workers, each one summing exactly into its own matrix
+    DB_Date start(date_range->start_date());
+    if (group_by_month)
+    {
+        const int first = end_month - columns + 1;
+        start = std::max(start, DB_Date((first / 12) * 10000 + (first % 12 + 1) * 100 + 1));
+    }
+    const int start_month = start.year() * 12 + start.month() - 1;
+    const int months = std::max(end_month - start_month + 1, 1);
+    const int workers = std::max(1, std::min(months, static_cast<int>(std::thread::hardware_concurrency())));
 
+    Model_CategoryCube& cube = Model_CategoryCube::instance();
+    cube.load();
 
-        const double convRate = Model_CurrencyHistory::getDayRate(
-            Model_Account::instance().get(transaction.ACCOUNTID)->CURRENCYID, transaction.TRANSDATE);
-        const wxDateTime &d = Model_Checking::TRANSDATE(transaction);
-        int idx = group_by_month ? (d.GetYear()*100 + d.GetMonth()) : 0;
-        int categID = transaction.CATEGID;
+    std::vector<std::vector<Money> > stats(workers);
+    auto work = [&](int w)
+    {
+        // ymd of the first day of the months of the worker, yyyymm00 for the day before
+        auto month_start = [&](int i) -> int
+        {
+            const int month = start_month + months * i / workers;
+            return (month / 12) * 10000 + (month % 12 + 1) * 100 + 1;
+        };
+        const DB_Date from(w == 0 ? start.ymd() : month_start(w));
+        const DB_Date to(w == workers - 1 ? end.ymd() : month_start(w + 1) - 1);
 
-        if (categID > -1)
+        std::vector<Money>& values = stats[w];
+        values.assign(size, Money());
+        cube.visit(from, to, [&](const Model_CategoryCube::Key& k, const Money& amount)
         {
-            if (Model_Checking::type(transaction) != Model_Checking::TRANSFER)
-            {
-                // Do not include asset or stock transfers in income expense calculations.
-                if (Model_Checking::foreignTransactionAsTransfer(transaction))
-                    continue;
-                categoryStats[categID][transaction.SUBCATEGID][idx] += Model_Checking::balance(transaction) * convRate;
-            }
-            else if (budgetAmt != 0)
+            if (k.categ < 0 || (accountArray && accounts.find(k.account) == accounts.end())) return;
+            const int node = tree.index(k.categ, k.subcateg);
+            const int m = group_by_month ? end_month - ((k.month / 100) * 12 + k.month % 100 - 1) : 0;
+            if (node < 0 || m < 0 || m >= columns) return;
+
+            // The parts of a split transaction all count, with the sign of its balance
+            if (k.split)
             {
-                double amt = transaction.TRANSAMOUNT * convRate;
-                if ((*budgetAmt)[categID][transaction.SUBCATEGID] < 0)
-                    categoryStats[categID][transaction.SUBCATEGID][idx] -= amt;
-                else
-                    categoryStats[categID][transaction.SUBCATEGID][idx] += amt;
+                const bool withdrawal = (k.type == Model_CategoryCube::WITHDRAWAL || k.type == Model_CategoryCube::WITHDRAWAL_AS_TRANSFER);
+                values[node * columns + m] += withdrawal ? -amount : amount;
+                return;
             }
-        }
-        else
-        {
-            for (const auto& entry: splits[transaction.id()])
+
+            switch (k.type)
             {
-                categoryStats[entry.CATEGID][entry.SUBCATEGID][idx] += entry.SPLITTRANSAMOUNT
-                    * convRate * (Model_Checking::balance(transaction) < 0 ? -1 : 1);
+            case Model_CategoryCube::WITHDRAWAL:
+                values[node * columns + m] -= amount;
+                break;
+            case Model_CategoryCube::DEPOSIT:
+                values[node * columns + m] += amount;
+                break;
+            case Model_CategoryCube::TRANSFER:
+                if (budgetAmt)
+                    values[node * columns + m] += negative_budget(k.categ, k.subcateg) ? -amount : amount;
+                break;
+            default:
+                // Do not include asset or stock transfers in income expense calculations.
+                break;
             }
-        }
+        });
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++)
+        threads.push_back(std::thread(work, w));
+    work(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        Money value;
+        for (const auto& values : stats)
+            value += values[i];
+        categoryStats.values_[i] = value.to_double(cube.precision());
     }
 }
 
+double Model_Category::Stats::operator()(int category_id, int subcategory_id, int key) const
+{
+    const int node = tree_ ? tree_->index(category_id, subcategory_id) : -1;
+    if (node < 0) return 0.0;
+
+    for (size_t m = 0; m < keys_.size(); ++m)
+    {
+        if (keys_[m] == key) return values_[node * keys_.size() + m];
+    }
+    return 0.0;
+}
+
+std::map<int, double> Model_Category::Stats::row(int category_id, int subcategory_id) const
+{
+    std::map<int, double> values;
+    const int node = tree_ ? tree_->index(category_id, subcategory_id) : -1;
+    for (size_t m = 0; m < keys_.size(); ++m)
+        values[keys_[m]] = (node < 0) ? 0.0 : values_[node * keys_.size() + m];
+    return values;
+}
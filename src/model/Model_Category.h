@@ -22,6 +22,7 @@
 #include "Model.h"
 #include "Table_Category.h"
 #include "Model_Subcategory.h"
+#include <memory>
 
 class mmDateRange;
 class Model_Category : public Model<DB_Table_CATEGORY>
@@ -59,12 +60,73 @@ public:
     static const wxString full_name(const int category_id, const int subcategory_id);
     static bool is_used(int id, int sub_id = -1);
     static bool has_income(int id, int sub_id = -1);
+    class Stats;
+    /**
+    * Sum the transactions by category and month in the base currency: twelve months back from
+    * the end date when grouped by month, else a single column with the key 0.
+    */
     static void getCategoryStats(
-        std::map<int, std::map<int, std::map<int, double> > > &categoryStats
+        Stats &categoryStats
         , const wxArrayString* accountArray
         , mmDateRange* date_range, bool ignoreFuture
         , bool group_by_month = true
         , std::map<int, std::map<int, double> > *budgetAmt = nullptr);
+
+public:
+    /**
+    * Snapshot of the categories and their subcategories in one flat array: each category
+    * sorted by name is followed by its subcategories sorted by name. A (CATEGID, SUBCATEGID)
+    * pair has a dense index into the array, usable to index arrays of aggregated values.
+    */
+    class Tree
+    {
+    public:
+        struct Node
+        {
+            int CATEGID;
+            int SUBCATEGID; // -1 for a category
+            int parent; // node of the category of a subcategory, -1 for a category
+            int children; // number of subcategories, in the nodes following the category
+            wxString full_name;
+        };
+
+        size_t size() const { return nodes_.size(); }
+        const Node& operator[](size_t i) const { return nodes_[i]; }
+        /** Return the node of the category, or of the subcategory when given, -1 when unknown */
+        int index(int category_id, int subcategory_id = -1) const;
+
+    private:
+        friend class Model_Category;
+        std::vector<Node> nodes_;
+        std::unordered_map<int /*CATEGID*/, int> categories_;
+        std::unordered_map<int /*SUBCATEGID*/, int> subcategories_;
+    };
+
+    /**
+    * Category statistics in a dense matrix: one row per node of the category tree, one column
+    * per month key (year * 100 + month - 1, or 0 when not grouped by month).
+    */
+    class Stats
+    {
+    public:
+        /** Value of the category, or of the subcategory when given, for the key; 0 when unknown */
+        double operator()(int category_id, int subcategory_id, int key) const;
+        /** Values of the category, or of the subcategory when given, by key */
+        std::map<int, double> row(int category_id, int subcategory_id) const;
+
+    private:
+        friend class Model_Category;
+        std::shared_ptr<const Tree> tree_; // the tree the stats were computed with, shared with Model_Category
+        std::vector<int> keys_; // key of each column
+        std::vector<double> values_; // node * keys_.size() + column
+    };
+
+    /** Return the category tree, rebuilt when the categories or subcategories changed */
+    const Tree& tree();
+
+private:
+    std::shared_ptr<const Tree> tree_; // replaced, never changed, when rebuilt
+    size_t tree_revision_[2]; // revisions of the categories and subcategories the tree is built from
 };
 
 #endif
@@ -0,0 +1,196 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "Model_CategoryCube.h"
+#include "Model_Account.h"
+#include "Model_CurrencyHistory.h"
+#include "option.h"
+#include <algorithm>
+
+Model_CategoryCube& Model_CategoryCube::instance()
+{
+    return Singleton<Model_CategoryCube>::instance();
+}
+
+void Model_CategoryCube::patch(const Model_Checking::Data* r)
+{
+    if (!sync(1, 0)) return;
+
+    erase(r->TRANSID);
+    Parts p;
+    parts(*r, Model_Splittransaction::instance().get_all(), p);
+    insert(r->TRANSID, r->TRANSDATE_YMD.ymd(), p);
+}
+
+void Model_CategoryCube::remove(int trans_id)
+{
+    if (!sync(1, 0)) return;
+
+    erase(trans_id);
+}
+
+void Model_CategoryCube::patch_splits(const std::vector<int>& trans_ids, size_t changes)
+{
+    if (!sync(0, changes)) return;
+
+    const auto& splits = Model_Splittransaction::instance().get_all();
+    for (const auto& trans_id : trans_ids)
+    {
+        erase(trans_id);
+        const Model_Checking::Data* r = Model_Checking::instance().get(trans_id);
+        if (!r) continue;
+
+        Parts p;
+        parts(*r, splits, p);
+        insert(trans_id, r->TRANSDATE_YMD.ymd(), p);
+    }
+}
+
+void Model_CategoryCube::reset()
+{
+    cells_.clear();
+    transactions_.clear();
+    dates_.clear();
+    currencies_.clear();
+    loaded_ = false;
+}
+
+/** The whole months between the dates, first_month > last_month when there is none */
+void Model_CategoryCube::months(const DB_Date& from, const DB_Date& to, int& first_month, int& last_month)
+{
+    static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    first_month = from.year_month();
+    if (from.day() > 1)
+        first_month += (from.month() == 12) ? 100 - 11 : 1;
+
+    last_month = to.year_month();
+    if (!to.is_valid()) return;
+    const int y = to.year();
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    if (to.day() < days[to.month() - 1] + (to.month() == 2 && leap ? 1 : 0))
+        last_month -= (to.month() == 1) ? 100 - 11 : 1;
+}
+
+void Model_CategoryCube::load()
+{
+    sync(0, 0);
+    if (loaded_) return;
+
+    const Model_Currency::Data* base_currency = Model_Currency::GetBaseCurrency();
+    precision_ = base_currency ? Model_Currency::precision(base_currency) : 2;
+    const auto& splits = Model_Splittransaction::instance().get_all();
+    Parts p;
+    Model_Checking::instance().for_each([&](const Model_Checking::Data& r) -> bool
+    {
+        p.clear();
+        parts(r, splits, p);
+        insert(r.TRANSID, r.TRANSDATE_YMD.ymd(), p);
+        return true;
+    });
+    loaded_ = true;
+}
+
+void Model_CategoryCube::revisions(size_t (&revision)[MAX_REVISION]) const
+{
+    revision[CHECKING] = Model_Checking::instance().revision_;
+    revision[SPLITS] = Model_Splittransaction::instance().revision_;
+    revision[ACCOUNTS] = Model_Account::instance().revision_;
+    revision[CURRENCIES] = Model_Currency::instance().revision_;
+    revision[RATES] = Model_CurrencyHistory::instance().revision_;
+    revision[BASE_CURRENCY] = Option::instance().getBaseCurrencyID();
+}
+
+/**
+* Check the cube against the revisions of the data it is made of, expecting the given
+* numbers of changes of the transactions and of the splits. Anything else resets the cube.
+* Return true when the cube is to be patched.
+*/
+bool Model_CategoryCube::sync(size_t transactions, size_t splits)
+{
+    size_t revision[MAX_REVISION];
+    revisions(revision);
+    if (std::equal(revision, revision + MAX_REVISION, revision_)) return false;
+
+    const bool patch = loaded_
+        && revision[CHECKING] == revision_[CHECKING] + transactions
+        && revision[SPLITS] == revision_[SPLITS] + splits
+        && std::equal(revision + ACCOUNTS, revision + MAX_REVISION, revision_ + ACCOUNTS);
+    if (!patch) reset();
+    std::copy(revision, revision + MAX_REVISION, revision_);
+    return patch;
+}
+
+/** The amounts the transaction adds to the cube, one per split if any */
+void Model_CategoryCube::parts(const Model_Checking::Data& r, const Model_Splittransaction::Index& splits, Parts& parts)
+{
+    const DB_Date& date = r.TRANSDATE_YMD;
+    if (!date.is_valid() || Model_Checking::status(r) == Model_Checking::VOID_) return;
+
+    int type = Model_Checking::type(r);
+    if (Model_Checking::foreignTransactionAsTransfer(r))
+        type = (type == Model_Checking::DEPOSIT) ? DEPOSIT_AS_TRANSFER : WITHDRAWAL_AS_TRANSFER;
+
+    auto currency = currencies_.find(r.ACCOUNTID);
+    if (currency == currencies_.end())
+    {
+        const Model_Account::Data* account = Model_Account::instance().get(r.ACCOUNTID);
+        currency = currencies_.insert(std::make_pair(r.ACCOUNTID, account ? account->CURRENCYID : -1)).first;
+    }
+    const double rate = Model_CurrencyHistory::getDayRate(currency->second, date);
+
+    const auto range = splits[r.TRANSID];
+    if (range.empty())
+    {
+        const Part part = { { date.year_month(), r.ACCOUNTID, r.CATEGID, r.SUBCATEGID, type, 0 }, Money(r.TRANSAMOUNT * rate, precision_) };
+        parts.push_back(part);
+    }
+    for (const auto& split : range)
+    {
+        const Part part = { { date.year_month(), r.ACCOUNTID, split.CATEGID, split.SUBCATEGID, type, 1 }, Money(split.SPLITTRANSAMOUNT * rate, precision_) };
+        parts.push_back(part);
+    }
+}
+
+void Model_CategoryCube::insert(int trans_id, int ymd, const Parts& parts)
+{
+    if (parts.empty()) return;
+
+    for (const auto& part : parts)
+    {
+        Cell& cell = cells_.insert(std::make_pair(part.key, Cell{ Money(), 0 })).first->second;
+        cell.amount += part.amount;
+        ++cell.count;
+    }
+    transactions_[std::make_pair(ymd, trans_id)] = parts;
+    dates_[trans_id] = ymd;
+}
+
+void Model_CategoryCube::erase(int trans_id)
+{
+    const auto date = dates_.find(trans_id);
+    if (date == dates_.end()) return;
+
+    const auto it = transactions_.find(std::make_pair(date->second, trans_id));
+    for (const auto& part : it->second)
+    {
+        const auto cell = cells_.find(part.key);
+        cell->second.amount -= part.amount;
+        if (--cell->second.count == 0) cells_.erase(cell);
+    }
+    transactions_.erase(it);
+    dates_.erase(date);
+}
@@ -0,0 +1,154 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include "Model_Checking.h"
+#include <climits>
+#include <tuple>
+
+/**
+* Amounts of the transactions summed by (month, account, category, subcategory, type):
+* the splits of a transaction count for their own categories, every amount is converted
+* to the base currency at the rate of its day, and void transactions are left out.
+* Amounts are positive as stored, the sign follows from the type. They are rounded to minor
+* units of the base currency (see Money and precision()), so the sums of the cube are exact.
+* The cube is built on first use, patched by the saves and removals of Model_Checking and
+* Model_Splittransaction, and rebuilt when anything else changes the transactions, the splits,
+* the accounts, the currencies, the currency rates or the base currency.
+*/
+class Model_CategoryCube
+{
+public:
+    /** Model_Checking::TYPE, with the transactions of foreignTransactionAsTransfer() apart */
+    enum TYPE
+    {
+        WITHDRAWAL = Model_Checking::WITHDRAWAL,
+        DEPOSIT = Model_Checking::DEPOSIT,
+        TRANSFER = Model_Checking::TRANSFER,
+        WITHDRAWAL_AS_TRANSFER,
+        DEPOSIT_AS_TRANSFER
+    };
+
+    struct Key
+    {
+        int month; // yyyymm, see DB_Date::year_month()
+        int account;
+        int categ;
+        int subcateg;
+        int type; // TYPE
+        int split; // 1 for the parts of a split transaction, 0 otherwise
+
+        bool operator < (const Key& r) const
+        {
+            return std::tie(month, account, categ, subcateg, type, split)
+                < std::tie(r.month, r.account, r.categ, r.subcateg, r.type, r.split);
+        }
+    };
+
+public:
+    /** Return the static instance of the cube */
+    static Model_CategoryCube& instance();
+
+public:
+    /** The precision of the amounts, the one of the base currency when the cube was loaded */
+    int precision() const { return precision_; }
+
+    /**
+    * Call visitor(const Key&, const Money& amount) for the amounts dated between from and to included.
+    * Whole months come summed from the cube, the days of a partial month one transaction at a time.
+    */
+    template<typename VISITOR>
+    void for_each(const DB_Date& from, const DB_Date& to, VISITOR visitor)
+    {
+        load();
+        visit(from, to, visitor);
+    }
+
+    /**
+    * Like for_each() on a cube already brought up to date by load(). It does not change the cube,
+    * so several threads can visit it at once as long as nothing else uses the models meanwhile.
+    */
+    template<typename VISITOR>
+    void visit(const DB_Date& from, const DB_Date& to, VISITOR visitor) const
+    {
+        int first_month, last_month;
+        months(from, to, first_month, last_month);
+        if (first_month > last_month)
+            return for_each_day(from.ymd(), to.ymd(), visitor);
+
+        for_each_day(from.ymd(), first_month * 100, visitor);
+        const Key first = { first_month, INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN };
+        for (auto it = cells_.lower_bound(first); it != cells_.end() && it->first.month <= last_month; ++it)
+            visitor(it->first, it->second.amount);
+        for_each_day(last_month * 100 + 100, to.ymd(), visitor);
+    }
+
+    /** Bring the cube up to date with the transactions, building it when missing or stale */
+    void load();
+
+public:
+    /** Move the contribution of the transaction just saved */
+    void patch(const Model_Checking::Data* r);
+    /** Drop the contribution of the transaction just removed */
+    void remove(int trans_id);
+    /** Recompute the transactions whose splits were just saved or removed, in the given number of changes */
+    void patch_splits(const std::vector<int>& trans_ids, size_t changes = 1);
+    /** Forget the cube, it is rebuilt on next use */
+    void reset();
+
+private:
+    struct Cell
+    {
+        Money amount;
+        int count; // parts summed in the cell, it is dropped at 0
+    };
+
+    struct Part
+    {
+        Key key;
+        Money amount;
+    };
+    typedef std::vector<Part> Parts;
+
+    enum { CHECKING = 0, SPLITS, ACCOUNTS, CURRENCIES, RATES, BASE_CURRENCY, MAX_REVISION };
+
+    template<typename VISITOR>
+    void for_each_day(int from_ymd, int to_ymd, VISITOR visitor) const
+    {
+        for (auto it = transactions_.lower_bound(std::make_pair(from_ymd, INT_MIN))
+            ; it != transactions_.end() && it->first.first <= to_ymd; ++it)
+        {
+            for (const auto& part : it->second)
+                visitor(part.key, part.amount);
+        }
+    }
+
+    static void months(const DB_Date& from, const DB_Date& to, int& first_month, int& last_month);
+    bool sync(size_t transactions, size_t splits);
+    void revisions(size_t (&revision)[MAX_REVISION]) const;
+    void parts(const Model_Checking::Data& r, const Model_Splittransaction::Index& splits, Parts& parts);
+    void insert(int trans_id, int ymd, const Parts& parts);
+    void erase(int trans_id);
+
+    std::map<Key, Cell> cells_;
+    std::map<std::pair<int /*ymd*/, int /*TRANSID*/>, Parts> transactions_;
+    std::unordered_map<int /*TRANSID*/, int /*ymd*/> dates_;
+    std::unordered_map<int /*ACCOUNTID*/, int /*CURRENCYID*/> currencies_;
+    int precision_ = 2;
+    bool loaded_ = false;
+    size_t revision_[MAX_REVISION] = {}; // of the data the cube is up to date with
+};
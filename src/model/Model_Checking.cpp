@@ -22,8 +22,12 @@
 #include "Model_Account.h"
 #include "Model_Payee.h"
 #include "Model_Category.h"
+#include "Model_CustomFieldData.h"
 #include <queue>
 #include "Model_Translink.h"
+#include "Model_Ledger.h"
+#include "Model_CheckingColumns.h"
+#include "Model_CategoryCube.h"
 
 const std::vector<std::pair<Model_Checking::TYPE, wxString> > Model_Checking::TYPE_CHOICES =
 {
@@ -93,13 +97,26 @@ Model_Checking& Model_Checking::instance()
     return Singleton<Model_Checking>::instance();
 }
 
+int Model_Checking::save(Data* r)
+{
+    Model<DB_Table_CHECKINGACCOUNT>::save(r);
+    Model_Ledger::instance().patch(r);
+    Model_CheckingColumns::instance().patch(r);
+    Model_CategoryCube::instance().patch(r);
+    return r->id();
+}
+
 bool Model_Checking::remove(int id)
 {
     //TODO: remove all split at once
     //Model_Splittransaction::instance().remove(Model_Splittransaction::instance().find(Model_Splittransaction::TRANSID(id)));
     for (const auto& r : Model_Splittransaction::instance().find(Model_Splittransaction::TRANSID(id)))
         Model_Splittransaction::instance().remove(r.SPLITTRANSID);
-    return this->remove(id, db_);
+    const bool removed = this->remove(id, db_);
+    Model_Ledger::instance().remove(id);
+    Model_CheckingColumns::instance().remove(id);
+    Model_CategoryCube::instance().remove(id);
+    return removed;
 }
 
 const Model_Splittransaction::Data_Set Model_Checking::splittransaction(const Data* r)
@@ -198,27 +215,39 @@ Model_Checking::STATUS_ENUM Model_Checking::status(const Data& r)
 {
     return status(r.STATUS);
 }
+wxString Model_Checking::account_status(const Data& r, int account_id)
+{
+    if (type(r) == TRANSFER)
+    {
+        if (account_id == r.TOACCOUNTID)
+            return r.STATUS.Right(1);
+        else if (account_id == r.ACCOUNTID)
+            return r.STATUS.Left(1);
+    }
+    return r.STATUS;
+}
+
 Model_Checking::STATUS_ENUM Model_Checking::status(const Data* r)
 {
     return status(r->STATUS);
 }
 
-double Model_Checking::amount(const Data* r, int account_id)
+double Model_Checking::amount(TYPE type, int trx_account_id, double trx_amount, double to_trx_amount, int account_id)
 {
     double sum = 0;
-    switch (type(r->TRANSCODE))
+    switch (type)
     {
     case WITHDRAWAL:
-        sum -= r->TRANSAMOUNT;
+        sum -= trx_amount;
         break;
     case DEPOSIT:
-        sum += r->TRANSAMOUNT;
+        sum += trx_amount;
         break;
     case TRANSFER:
-        if (account_id == r->ACCOUNTID)
-            sum -= r->TRANSAMOUNT;
+        if (account_id == trx_account_id)
+            sum -= trx_amount;
         else
-            sum += r->TOTRANSAMOUNT;
+            sum += to_trx_amount;
         break;
     default:
         break;
@@ -226,6 +255,11 @@ double Model_Checking::amount(const Data* r, int account_id)
     return sum;
 }
 
+double Model_Checking::amount(const Data* r, int account_id)
+{
+    return amount(type(r->TRANSCODE), r->ACCOUNTID, r->TRANSAMOUNT, r->TOTRANSAMOUNT, account_id);
+}
+
 double Model_Checking::amount(const Data&r, int account_id)
 {
     return amount(&r, account_id);
@@ -275,6 +309,36 @@ double Model_Checking::reconciled(const Data& r, int account_id)
     return reconciled(&r, account_id);
 }
 
+Money Model_Checking::amount(const Data* r, int account_id, int precision)
+{
+    return Money(amount(r, account_id), precision);
+}
+
+Money Model_Checking::amount(const Data& r, int account_id, int precision)
+{
+    return amount(&r, account_id, precision);
+}
+
+Money Model_Checking::balance(const Data* r, int account_id, int precision)
+{
+    return Money(balance(r, account_id), precision);
+}
+
+Money Model_Checking::balance(const Data& r, int account_id, int precision)
+{
+    return balance(&r, account_id, precision);
+}
+
+Money Model_Checking::reconciled(const Data* r, int account_id, int precision)
+{
+    return Money(reconciled(r, account_id), precision);
+}
+
+Money Model_Checking::reconciled(const Data& r, int account_id, int precision)
+{
+    return reconciled(&r, account_id, precision);
+}
+
 bool Model_Checking::is_transfer(const wxString& r)
 {
     return type(r) == Model_Checking::TRANSFER;
@@ -307,49 +371,43 @@ Model_Checking::Full_Data::Full_Data(int account_id, const Data& r) : Data(r), A
     Initialise(account_id, r);
 }
 
-Model_Checking::Full_Data::Full_Data(int account_id, const Data& r
-    , const std::map<int /*trans id*/, Model_Splittransaction::Data_Set /*split trans*/ > & splits)
+Model_Checking::Full_Data::Full_Data(int account_id, const Data& r, const Model_Splittransaction::Index& splits)
     : Data(r), AMOUNT(0), BALANCE(0)
 {
-    const auto it = splits.find(this->id());
-    if (it != splits.end()) m_splits = it->second;
+    const auto range = splits[this->id()];
+    m_splits.assign(range.begin(), range.end());
 
     Initialise(account_id, r);
 }
 
+/* The category of the transaction, or the categories of its splits after a " * " */
+template<class SPLITS>
+static wxString category_name(const Model_Checking::Data& r, const SPLITS& splits)
+{
+    if (splits.empty())
+        return Model_Category::full_name(r.CATEGID, r.SUBCATEGID);
+
+    wxString name;
+    for (const auto& entry : splits)
+        name += (name.empty() ? " * " : ", ") + Model_Category::full_name(entry.CATEGID, entry.SUBCATEGID);
+    return name;
+}
+
 void Model_Checking::Full_Data::Initialise(int account_id, const Data& r)
 {
     ACCOUNTNAME = Model_Account::get_account_name(r.ACCOUNTID);
-    STATUSFD = r.STATUS;
+    STATUSFD = account_status(r, account_id);
     if (Model_Checking::type(r) == Model_Checking::TRANSFER)
     {
         TOACCOUNTNAME = Model_Account::get_account_name(r.TOACCOUNTID);
         PAYEENAME = TOACCOUNTNAME;
-        if (account_id == r.TOACCOUNTID)
-        {
-            STATUSFD = r.STATUS.Right(1);
-        }
-        else if (account_id == r.ACCOUNTID)
-        {
-            STATUSFD = r.STATUS.Left(1);
-        }
-
     }
     else
     {
         PAYEENAME = Model_Payee::get_payee_name(r.PAYEEID);
     }
 
-    if (!m_splits.empty())
-    {
-        for (const auto& entry : m_splits)
-            this->CATEGNAME += (this->CATEGNAME.empty() ? " * " : ", ")
-            + Model_Category::full_name(entry.CATEGID, entry.SUBCATEGID);
-    }
-    else
-    {
-        CATEGNAME = Model_Category::full_name(r.CATEGID, r.SUBCATEGID);
-    }
+    CATEGNAME = category_name(r, m_splits);
 }
 
 Model_Checking::Full_Data::~Full_Data()
@@ -392,6 +450,92 @@ wxString Model_Checking::Full_Data::info() const
     return info;
 }
 
+Model_Checking::Row::Row(int account_id, int trans_id, double amount, double balance)
+    : account_id(account_id), TRANSID(trans_id), AMOUNT(amount), BALANCE(balance)
+{
+}
+
+const Model_Checking::Data* Model_Checking::Row::data() const
+{
+    const Data* r = Model_Checking::instance().get(TRANSID);
+    return r && r->TRANSID == TRANSID ? r : 0; // get() returns a blank record for an unknown id
+}
+
+Model_Checking::Full_Data Model_Checking::Row::full_data() const
+{
+    const Data* r = data();
+    if (!r) return Full_Data();
+
+    Full_Data full_tran(account_id, *r, Model_Splittransaction::instance().get_all());
+    full_tran.AMOUNT = AMOUNT;
+    full_tran.BALANCE = BALANCE;
+    return full_tran;
+}
+
+Model_Splittransaction::Index::Range Model_Checking::Row::splits() const
+{
+    return Model_Splittransaction::instance().get_all()[TRANSID];
+}
+
+bool Model_Checking::Row::has_split() const
+{
+    return !splits().empty();
+}
+
+wxString Model_Checking::Row::payee_name() const
+{
+    const Data* r = data();
+    if (!r) return wxEmptyString;
+
+    if (TYPE::TRANSFER == type(r->TRANSCODE))
+    {
+        if (r->ACCOUNTID == account_id || account_id == -1)
+            return ("> " + Model_Account::get_account_name(r->TOACCOUNTID));
+        else
+            return ("< " + Model_Account::get_account_name(r->ACCOUNTID));
+    }
+
+    return Model_Payee::get_payee_name(r->PAYEEID);
+}
+
+wxString Model_Checking::Row::category_name() const
+{
+    const Data* r = data();
+    return r ? ::category_name(*r, splits()) : wxString();
+}
+
+wxString Model_Checking::Row::status() const
+{
+    const Data* r = data();
+    return r ? account_status(*r, account_id) : wxString();
+}
+
+wxString Model_Checking::Row::udfc(int slot) const
+{
+    return Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(TRANSID, slot);
+}
+
+bool Model_Checking::Row::is_foreign() const
+{
+    const Data* r = data();
+    return r && foreignTransaction(*r);
+}
+
+bool Model_Checking::Row::is_foreign_transfer() const
+{
+    const Data* r = data();
+    return r && foreignTransactionAsTransfer(*r);
+}
+
+wxString Model_Checking::Row::info() const
+{
+    const Data* r = data();
+    if (!r) return wxEmptyString;
+
+    wxDate date = Model_Checking::TRANSDATE(r);
+    return wxGetTranslation(date.GetEnglishWeekDayName(date.GetWeekDay()));
+}
+
 void Model_Checking::getFrequentUsedNotes(std::vector<wxString> &frequentNotes, int accountID)
 {
     frequentNotes.clear();
@@ -22,11 +22,13 @@
 #include "Model.h"
 #include "Table_Checkingaccount.h"
 #include "Model_Splittransaction.h"
+#include "Money.h"
 
 class Model_Checking : public Model<DB_Table_CHECKINGACCOUNT>
 {
 public:
     using Model<DB_Table_CHECKINGACCOUNT>::remove;
+    using Model<DB_Table_CHECKINGACCOUNT>::save;
     typedef Model_Splittransaction::Data_Set Split_Data_Set;
 
 public:
@@ -41,9 +43,7 @@ public:
     {
         Full_Data();
         explicit Full_Data(int account_id, const Data& r);
-        Full_Data(int account_id, const Data& r
-            , const std::map<int /*trans id*/
-                , Model_Splittransaction::Data_Set /*split trans*/ > & splits);
+        Full_Data(int account_id, const Data& r, const Model_Splittransaction::Index& splits);
         ~Full_Data();
         wxString ACCOUNTNAME, TOACCOUNTNAME;
         wxString PAYEENAME;
@@ -74,6 +74,40 @@ public:
     };
     typedef std::vector<Full_Data> Full_Data_Set;
 
+    /**
+    * A transaction as the register of an account shows it, without a copy of the record:
+    * the TRANSID with the AMOUNT and running BALANCE for the account. The record, the names,
+    * the splits and the custom fields are looked up in the caches of the models when asked,
+    * so only the rows on screen pay for them. See Full_Data for the copy.
+    */
+    struct Row
+    {
+        Row(int account_id, int trans_id, double amount = 0, double balance = 0);
+        int account_id; // the account the transaction is seen from
+        int TRANSID;
+        double AMOUNT;
+        double BALANCE;
+
+        /** Return the record from the cache of the model, 0 once removed */
+        const Data* data() const;
+        /** Return a copy of the transaction with the names resolved, for the dialogs */
+        Full_Data full_data() const;
+        Model_Splittransaction::Index::Range splits() const;
+        bool has_split() const;
+        /** Full_Data::real_payee_name() for the account */
+        wxString payee_name() const;
+        /** Full_Data::CATEGNAME */
+        wxString category_name() const;
+        /** Full_Data::STATUSFD */
+        wxString status() const;
+        /** The content of UDFC01 .. UDFC05 for the slots 0 .. 4 */
+        wxString udfc(int slot) const;
+        bool is_foreign() const;
+        bool is_foreign_transfer() const;
+        wxString info() const;
+    };
+    typedef std::vector<Row> Row_Set;
+
     struct SorterByBALANCE
     {
         template<class DATA>
@@ -132,6 +166,8 @@ public:
     static Model_Checking& instance();
 
 public:
+    /** Save the transaction and patch the ledgers of its accounts, see Model_Ledger */
+    int save(Data* r);
     bool remove(int id);
 
 public:
@@ -153,6 +189,9 @@ public:
     static STATUS_ENUM status(const wxString& r);
     static STATUS_ENUM status(const Data* r);
     static STATUS_ENUM status(const Data& r);
+    /** STATUS of the transaction for the account, the one of its side for a transfer (Full_Data::STATUSFD) */
+    static wxString account_status(const Data& r, int account_id);
+    static double amount(TYPE type, int trx_account_id, double trx_amount, double to_trx_amount, int account_id = -1);
     static double amount(const Data* r, int account_id = -1);
     static double amount(const Data&r, int account_id = -1);
     static double balance(const Data* r, int account_id = -1);
@@ -163,6 +202,13 @@ public:
     static double deposit(const Data& r, int account_id);
     static double reconciled(const Data* r, int account_id);
     static double reconciled(const Data& r, int account_id);
+    /** amount(), balance() and reconciled() in minor units of the given precision, see Model_Currency::precision() */
+    static Money amount(const Data* r, int account_id, int precision);
+    static Money amount(const Data& r, int account_id, int precision);
+    static Money balance(const Data* r, int account_id, int precision);
+    static Money balance(const Data& r, int account_id, int precision);
+    static Money reconciled(const Data* r, int account_id, int precision);
+    static Money reconciled(const Data& r, int account_id, int precision);
     static bool is_transfer(const wxString& r);
     static bool is_transfer(const Data* r);
     static bool is_deposit(const wxString& r);
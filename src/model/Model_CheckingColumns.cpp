@@ -0,0 +1,267 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "Model_CheckingColumns.h"
+#include "Model_Account.h"
+
+Model_CheckingColumns::Filter::Filter()
+    : from_ymd(0), to_ymd(INT_MAX), types(~0u), statuses(~0u), as_transfer(true)
+{
+}
+
+Model_CheckingColumns& Model_CheckingColumns::instance()
+{
+    return Singleton<Model_CheckingColumns>::instance();
+}
+
+const Model_CheckingColumns::Columns& Model_CheckingColumns::columns()
+{
+    sync(0);
+    if (!loaded_) load();
+    return columns_;
+}
+
+/*
+* The kernels below run over whole columns without branching on the rows: each row is
+* added multiplied by its 0/1 selection mask, see Selector. The amounts are summed in minor
+* units by dense account index, and converted once at the precision of each account.
+*/
+namespace
+{
+    class Selector
+    {
+    public:
+        Selector(const Model_CheckingColumns::Columns& c, const Model_CheckingColumns::Filter& filter)
+            : ymd_(c.ymd.data()), type_(c.type.data()), status_(c.status.data()), as_transfer_(c.as_transfer.data())
+            , from_(filter.from_ymd), to_(filter.to_ymd), types_(filter.types), statuses_(filter.statuses)
+            , include_as_transfer_(filter.as_transfer ? 1 : 0)
+        {}
+
+        unsigned operator()(size_t i) const
+        {
+            return (ymd_[i] >= from_) & (ymd_[i] <= to_)
+                & (types_ >> type_[i]) & (statuses_ >> status_[i])
+                & (include_as_transfer_ | (as_transfer_[i] ^ 1u));
+        }
+
+    private:
+        const int* ymd_;
+        const unsigned char* type_;
+        const unsigned char* status_;
+        const unsigned char* as_transfer_;
+        const int from_, to_;
+        const unsigned types_, statuses_, include_as_transfer_;
+    };
+}
+
+size_t Model_CheckingColumns::count(const Filter& filter)
+{
+    const Columns& c = columns();
+    const Selector selected(c, filter);
+    const size_t n = c.size();
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i)
+        total += selected(i);
+    return total;
+}
+
+std::map<int, Model_CheckingColumns::Totals> Model_CheckingColumns::by_account(const Filter& filter)
+{
+    const Columns& c = columns();
+    const Selector selected(c, filter);
+    const size_t n = c.size();
+    const size_t accounts = accounts_.size();
+
+    // one slot per dense account index, index 0 collects the rows without a TOACCOUNTID
+    struct Slot
+    {
+        long long balance, reconciled;
+        int count, followup, to_count;
+    };
+    std::vector<Slot> slots(accounts, Slot{ 0, 0, 0, 0, 0 });
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int m = selected(i);
+        Slot& a = slots[c.account[i]];
+        a.balance += m * c.balance[i];
+        a.reconciled += m * c.reconciled[i];
+        a.count += m;
+        a.followup += m & (c.status[i] == Model_Checking::FOLLOWUP);
+        Slot& t = slots[c.to_account[i]];
+        t.balance += m * c.to_balance[i];
+        t.reconciled += m * c.to_reconciled[i];
+        t.to_count += m;
+    }
+
+    std::map<int, Totals> totals;
+    for (size_t a = 1; a < accounts; ++a)
+    {
+        if (slots[a].count == 0 && slots[a].to_count == 0) continue;
+        Totals& t = totals[accounts_[a]];
+        t.balance = Money::from_units(slots[a].balance).to_double(precisions_[a]);
+        t.reconciled = Money::from_units(slots[a].reconciled).to_double(precisions_[a]);
+        t.count = slots[a].count;
+        t.followup = slots[a].followup;
+    }
+    return totals;
+}
+
+void Model_CheckingColumns::patch(const Model_Checking::Data* r)
+{
+    if (!sync(1) || !loaded_) return;
+
+    const auto it = rows_.find(r->TRANSID);
+    if (it != rows_.end()) erase(it->second);
+    push_back(*r);
+}
+
+void Model_CheckingColumns::remove(int trans_id)
+{
+    if (!sync(1) || !loaded_) return;
+
+    const auto it = rows_.find(trans_id);
+    if (it != rows_.end()) erase(it->second);
+}
+
+void Model_CheckingColumns::reset()
+{
+    columns_ = Columns();
+    rows_.clear();
+    accounts_.clear();
+    precisions_.clear();
+    account_indexes_.clear();
+    loaded_ = false;
+    revision_ = Model_Checking::instance().revision_;
+    accounts_revision_ = Model_Account::instance().revision_;
+    currencies_revision_ = Model_Currency::instance().revision_;
+}
+
+/**
+* Check the columns against the revision of Model_Checking, expecting the given number of
+* changes made through Model_Checking::save() or remove(). Anything else resets the columns,
+* so does any change of the accounts or the currencies the precisions come from.
+* Return true when the columns are to be patched.
+*/
+bool Model_CheckingColumns::sync(size_t changes)
+{
+    if (Model_Account::instance().revision_ != accounts_revision_
+        || Model_Currency::instance().revision_ != currencies_revision_)
+    {
+        reset();
+        return false;
+    }
+
+    const size_t revision = Model_Checking::instance().revision_;
+    if (revision == revision_) return false;
+
+    const bool patch = (revision == revision_ + changes);
+    if (!patch) reset();
+    revision_ = revision;
+    return patch;
+}
+
+void Model_CheckingColumns::load()
+{
+    reset();
+    accounts_.push_back(-1);
+    precisions_.push_back(0);
+
+    Model_Checking::instance().for_each([this](const Model_Checking::Data& r) -> bool
+    {
+        push_back(r);
+        return true;
+    });
+    loaded_ = true;
+}
+
+void Model_CheckingColumns::push_back(const Model_Checking::Data& r)
+{
+    Columns& c = columns_;
+    const Model_Checking::TYPE type = Model_Checking::type(r);
+    const bool transfer = (type == Model_Checking::TRANSFER);
+    const DB_Date& date = r.TRANSDATE_YMD;
+    const int account = account_index(r.ACCOUNTID);
+    const int to_account = transfer ? account_index(r.TOACCOUNTID) : 0;
+    const int precision = precisions_[account], to_precision = precisions_[to_account];
+
+    rows_[r.TRANSID] = c.size();
+    c.TRANSID.push_back(r.TRANSID);
+    c.ACCOUNTID.push_back(r.ACCOUNTID);
+    c.TOACCOUNTID.push_back(r.TOACCOUNTID);
+    c.PAYEEID.push_back(r.PAYEEID);
+    c.CATEGID.push_back(r.CATEGID);
+    c.SUBCATEGID.push_back(r.SUBCATEGID);
+    c.ymd.push_back(date.ymd());
+    c.type.push_back(static_cast<unsigned char>(type));
+    c.status.push_back(static_cast<unsigned char>(Model_Checking::status(r)));
+    c.as_transfer.push_back(Model_Checking::foreignTransactionAsTransfer(r) ? 1 : 0);
+    c.amount.push_back(r.TRANSAMOUNT);
+    c.to_amount.push_back(r.TOTRANSAMOUNT);
+    c.balance.push_back(Model_Checking::balance(r, r.ACCOUNTID, precision).units());
+    c.reconciled.push_back(Model_Checking::reconciled(r, r.ACCOUNTID, precision).units());
+    c.to_balance.push_back(transfer ? Model_Checking::balance(r, r.TOACCOUNTID, to_precision).units() : 0);
+    c.to_reconciled.push_back(transfer ? Model_Checking::reconciled(r, r.TOACCOUNTID, to_precision).units() : 0);
+    c.account.push_back(account);
+    c.to_account.push_back(to_account);
+}
+
+template<typename T>
+static void move_last(std::vector<T>& v, size_t row)
+{
+    v[row] = v.back();
+    v.pop_back();
+}
+
+/** Remove a row by moving the last row in its place */
+void Model_CheckingColumns::erase(size_t row)
+{
+    Columns& c = columns_;
+    const size_t last = c.size() - 1;
+    rows_.erase(c.TRANSID[row]);
+    if (row != last) rows_[c.TRANSID[last]] = row;
+
+    move_last(c.TRANSID, row);
+    move_last(c.ACCOUNTID, row);
+    move_last(c.TOACCOUNTID, row);
+    move_last(c.PAYEEID, row);
+    move_last(c.CATEGID, row);
+    move_last(c.SUBCATEGID, row);
+    move_last(c.ymd, row);
+    move_last(c.type, row);
+    move_last(c.status, row);
+    move_last(c.as_transfer, row);
+    move_last(c.amount, row);
+    move_last(c.to_amount, row);
+    move_last(c.balance, row);
+    move_last(c.reconciled, row);
+    move_last(c.to_balance, row);
+    move_last(c.to_reconciled, row);
+    move_last(c.account, row);
+    move_last(c.to_account, row);
+}
+
+int Model_CheckingColumns::account_index(int account_id)
+{
+    const auto it = account_indexes_.find(account_id);
+    if (it != account_indexes_.end()) return it->second;
+
+    const int index = static_cast<int>(accounts_.size());
+    accounts_.push_back(account_id);
+    const Model_Account::Data* account = Model_Account::instance().get(account_id);
+    precisions_.push_back(account ? Model_Currency::precision(Model_Account::currency(account)) : 2);
+    account_indexes_[account_id] = index;
+    return index;
+}
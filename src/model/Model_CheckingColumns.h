@@ -0,0 +1,120 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include "Model_Checking.h"
+#include <climits>
+
+/**
+* Read only mirror of CHECKINGACCOUNT in columns (one array per field) for aggregations:
+* ids, packed dates, TYPE and STATUS_ENUM codes, amounts, and the amounts each transaction
+* adds to its accounts following Model_Checking::balance() and reconciled(), in minor units
+* of the currency of each account (see Money) so that the kernels sum them exactly.
+* The columns are built on first use, patched by Model_Checking::save() and remove(),
+* and rebuilt when the table is changed in any other way (bulk save, update_where ...)
+* or when the accounts or the currencies change.
+* The order of the rows is arbitrary.
+*/
+class Model_CheckingColumns
+{
+public:
+    struct Columns
+    {
+        std::vector<int> TRANSID;
+        std::vector<int> ACCOUNTID;
+        std::vector<int> TOACCOUNTID;
+        std::vector<int> PAYEEID;
+        std::vector<int> CATEGID;
+        std::vector<int> SUBCATEGID;
+        std::vector<int> ymd; // TRANSDATE as yyyymmdd, 0 when not a date
+        std::vector<unsigned char> type; // Model_Checking::TYPE
+        std::vector<unsigned char> status; // Model_Checking::STATUS_ENUM
+        std::vector<unsigned char> as_transfer; // Model_Checking::foreignTransactionAsTransfer()
+        std::vector<double> amount; // TRANSAMOUNT
+        std::vector<double> to_amount; // TOTRANSAMOUNT
+        std::vector<long long> balance; // balance() for ACCOUNTID, in minor units of its currency
+        std::vector<long long> reconciled; // reconciled() for ACCOUNTID, in minor units of its currency
+        std::vector<long long> to_balance; // balance() for TOACCOUNTID of a transfer, 0 otherwise
+        std::vector<long long> to_reconciled; // reconciled() for TOACCOUNTID of a transfer, 0 otherwise
+        std::vector<int> account; // dense index of ACCOUNTID, see account_id()
+        std::vector<int> to_account; // dense index of TOACCOUNTID of a transfer, 0 otherwise
+
+        size_t size() const { return TRANSID.size(); }
+    };
+
+    /** The rows an aggregation is made of */
+    struct Filter
+    {
+        Filter();
+        int from_ymd; // TRANSDATE range, both included
+        int to_ymd;
+        unsigned types; // bit (1 << Model_Checking::TYPE) of the types included
+        unsigned statuses; // bit (1 << Model_Checking::STATUS_ENUM) of the statuses included
+        bool as_transfer; // include the transactions Model_Translink counts as transfers
+    };
+
+    struct Totals
+    {
+        Totals() : balance(0), reconciled(0), count(0), followup(0) {}
+        double balance;
+        double reconciled;
+        int count; // transactions of ACCOUNTID
+        int followup; // transactions of ACCOUNTID with the follow up status
+    };
+
+public:
+    /** Return the static instance of the columns */
+    static Model_CheckingColumns& instance();
+
+public:
+    const Columns& columns();
+    /** Return the ACCOUNTID of a dense account index, -1 for index 0 (none) */
+    int account_id(int index) const { return accounts_[index]; }
+    size_t accounts() const { return accounts_.size(); }
+    /** Return the precision of the amounts of a dense account index, see Model_Currency::precision() */
+    int precision(int index) const { return precisions_[index]; }
+
+    /** Number of the transactions selected */
+    size_t count(const Filter& filter);
+    /** Balances and reconciled balances by account, transfers counting for both accounts */
+    std::map<int /*ACCOUNTID*/, Totals> by_account(const Filter& filter);
+
+public:
+    /** Move the transaction just saved to its row */
+    void patch(const Model_Checking::Data* r);
+    /** Drop the row of the transaction just removed */
+    void remove(int trans_id);
+    /** Forget every row, they are reloaded on next use */
+    void reset();
+
+private:
+    bool sync(size_t changes);
+    void load();
+    void push_back(const Model_Checking::Data& r);
+    void erase(size_t row);
+    int account_index(int account_id);
+
+    Columns columns_;
+    std::unordered_map<int /*TRANSID*/, size_t /*row*/> rows_;
+    std::vector<int> accounts_; // ACCOUNTID of the dense account indexes, index 0 for none
+    std::vector<int> precisions_; // of the currencies of the dense account indexes
+    std::unordered_map<int /*ACCOUNTID*/, int> account_indexes_;
+    bool loaded_ = false;
+    size_t revision_ = 0; // revision of Model_Checking the columns are up to date with
+    size_t accounts_revision_ = 0; // of Model_Account, for the currencies of the accounts
+    size_t currencies_revision_ = 0; // of Model_Currency, for their precisions
+};
@@ -21,6 +21,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 Model_CurrencyHistory::Model_CurrencyHistory()
 : Model<DB_Table_CURRENCYHISTORY>()
+, timelines_loaded_(false)
+, timelines_revision_(0)
 {
 };
 
@@ -37,6 +39,8 @@ Model_CurrencyHistory& Model_CurrencyHistory::instance(wxSQLite3Database* db)
     Model_CurrencyHistory& ins = Singleton<Model_CurrencyHistory>::instance();
     ins.db_ = db;
     ins.ensure(db);
+    ins.timelines_.clear();
+    ins.timelines_loaded_ = false;
 
     return ins;
 }
@@ -79,12 +83,32 @@ int Model_CurrencyHistory::addUpdate(const int& currencyID, const wxDate& date,
     currHist->CURRDATE = date.FormatISODate();
     currHist->CURRVALUE = price;
     currHist->CURRUPDTYPE = type;
-    return save(currHist);
+    const size_t revision = this->revision_;
+    save(currHist);
+
+    // keep the timeline of the currency in step, unless it is stale anyway
+    if (timelines_loaded_ && timelines_revision_ == revision && this->revision_ == revision + 1)
+    {
+        const DB_Date day(date);
+        Timeline& rates = timelines_[currencyID];
+        auto it = std::lower_bound(rates.begin(), rates.end(), day
+            , [](const Rate& r, const DB_Date& d) { return r.date < d; });
+        if (it != rates.end() && it->date == day)
+            it->value = price;
+        else if (day.is_valid())
+            rates.insert(it, Rate{ day, price });
+        timelines_revision_ = this->revision_;
+    }
+    return currHist->id();
 }
 
 /** Return the rate for a specific currency in a specific day*/
 double Model_CurrencyHistory::getDayRate(const int& currencyID, const wxString& DateISO)
 {
+    const DB_Date date(DateISO);
+    if (date.is_valid())
+        return Model_CurrencyHistory::getDayRate(currencyID, date);
+
     wxDate Date;
     if (Date.ParseDate(DateISO))
         return Model_CurrencyHistory::getDayRate(currencyID, Date);
@@ -94,98 +118,108 @@ double Model_CurrencyHistory::getDayRate(const int& currencyID, const wxString&
 
 double Model_CurrencyHistory::getDayRate(const int& currencyID, const wxDate& Date)
 {
-    if (currencyID == Model_Currency::GetBaseCurrency()->CURRENCYID || currencyID == -1)
+    return Model_CurrencyHistory::getDayRate(currencyID, DB_Date(Date));
+}
+
+double Model_CurrencyHistory::getDayRate(const int& currencyID, const DB_Date& date)
+{
+    if (currencyID == Model_Currency::GetBaseCurrency()->CURRENCYID || currencyID == -1 || !date.is_valid())
         return 1;
 
-    Model_CurrencyHistory::Data_Set Data = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID),Model_CurrencyHistory::CURRDATE(Date));
+    const Timeline& rates = Model_CurrencyHistory::instance().timeline(currencyID);
+    const auto next = std::upper_bound(rates.begin(), rates.end(), date
+        , [](const DB_Date& d, const Rate& r) { return d < r.date; });
+    return nearest(rates, next, date);
+}
 
-    if (!Data.empty())
-    {
-        //Rate found for specified day
-        return Data.back().CURRVALUE;
-    }
-    else if (Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID)).size() > 0)
+void Model_CurrencyHistory::applyDayRate(const int& currencyID, std::vector<std::pair<DB_Date, double> >& amounts)
+{
+    if (currencyID == Model_Currency::GetBaseCurrency()->CURRENCYID || currencyID == -1)
+        return;
+
+    const Timeline& rates = Model_CurrencyHistory::instance().timeline(currencyID);
+    if (rates.empty()) return;
+
+    auto next = rates.begin(); // first rate after the date of the previous amount
+    DB_Date previous;
+    for (auto& amount : amounts)
     {
-        //Rate not found for specified day
-        //Custom query requested to speed-up performances, no way to obtain it with our ORM
-        wxDateTime dFuture, dPast, dNearest;
-        wxString DateISO = Date.FormatISODate();
-
-        const wxString sqlPast = wxString::Format("SELECT MAX(currdate) FROM CURRENCYHISTORY WHERE currencyid = '%i' AND currdate <= '%s';", currencyID, DateISO);
-        wxSQLite3ResultSet rsPast = Model_CurrencyHistory::instance().db_->ExecuteQuery(sqlPast);
-        while (rsPast.NextRow())
-        {
-            dPast.ParseDate(rsPast.GetAsString(0));
-        }
-
-        const wxString sqlFuture = wxString::Format("SELECT MIN(currdate) FROM CURRENCYHISTORY WHERE currencyid = '%i' AND currdate >= '%s';", currencyID, DateISO);
-        wxSQLite3ResultSet rsFuture = Model_CurrencyHistory::instance().db_->ExecuteQuery(sqlFuture);
-        while (rsFuture.NextRow())
-        {
-            dFuture.ParseDate(rsFuture.GetAsString(0));
-        }
-
-        if (dPast.IsValid() && dFuture.IsValid())
-        {
-            const wxTimeSpan spanPast = Date.Subtract(dPast);
-            const wxTimeSpan spanFuture = dFuture.Subtract(Date);
-
-            dNearest = spanPast <= spanFuture ? dPast : dFuture;
-        }
-        else if (dPast.IsValid())
-        {
-            dNearest = dPast;
-        }
-        else if (dFuture.IsValid())
-        {
-            dNearest = dFuture;
-        }
-        else
-        {
-            //TODO: Show warning alert but only one time?
-            return 1;
-        }
-
-        return Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID), Model_CurrencyHistory::CURRDATE(dNearest))[0].CURRVALUE;
+        const DB_Date& date = amount.first;
+        if (!date.is_valid()) continue;
+
+        if (date < previous)
+            next = rates.begin();
+        while (next != rates.end() && next->date <= date)
+            ++next;
+        previous = date;
+
+        amount.second *= nearest(rates, next, date);
     }
-    else
+}
+
+/** The rate of the date itself, or else of the closest date, the earlier one on a tie */
+double Model_CurrencyHistory::nearest(const Timeline& rates, Timeline::const_iterator next, const DB_Date& date)
+{
+    if (next == rates.begin())
+        return next == rates.end() ? 1 : next->value;
+
+    const auto past = next - 1;
+    if (past->date == date || next == rates.end())
+        return past->value;
+
+    return (date.days() - past->date.days()) <= (next->date.days() - date.days())
+        ? past->value : next->value;
+}
+
+/** Return the rates of the currency, loading the rates of every currency when stale */
+const Model_CurrencyHistory::Timeline& Model_CurrencyHistory::timeline(int currencyID)
+{
+    if (!timelines_loaded_ || timelines_revision_ != this->revision_)
     {
-        return 1;
+        timelines_.clear();
+        this->for_each([this](const Data& r) -> bool
+            {
+                if (!r.CURRDATE_YMD.is_valid()) return true;
+                Timeline& rates = timelines_[r.CURRENCYID];
+                if (!rates.empty() && rates.back().date == r.CURRDATE_YMD)
+                    rates.back().value = r.CURRVALUE; // the last one saved for the day
+                else
+                    rates.push_back(Rate{ r.CURRDATE_YMD, r.CURRVALUE });
+                return true;
+            }
+            , ORDER_BY<DB_Table_CURRENCYHISTORY::CURRENCYID>()
+            , ORDER_BY<DB_Table_CURRENCYHISTORY::CURRDATE>()
+            , ORDER_BY<DB_Table_CURRENCYHISTORY::CURRHISTID>());
+        timelines_loaded_ = true;
+        timelines_revision_ = this->revision_;
     }
+
+    return timelines_[currencyID];
 }
 
 /** Return the last currency rate */
 double Model_CurrencyHistory::getLastRate(const int& currencyID)
 {
-    Model_CurrencyHistory::Data_Set histData = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID));
-    std::stable_sort(histData.begin(), histData.end(), SorterByCURRDATE());
-
-    if (!histData.empty())
-        return histData.back().CURRVALUE;
-    else
-        return 1;
+    const Timeline& rates = Model_CurrencyHistory::instance().timeline(currencyID);
+    return rates.empty() ? 1 : rates.back().value;
 }
 
 /** Return the last currency rate not after the date */
 double Model_CurrencyHistory::getLastRate(const int& currencyID, const wxString& dateISO)
 {
-    Model_CurrencyHistory::Data_Set histData = Model_CurrencyHistory::instance().find(Model_CurrencyHistory::CURRENCYID(currencyID));
-    if (histData.empty())
+    const Timeline& rates = Model_CurrencyHistory::instance().timeline(currencyID);
+    if (rates.empty())
         return 1;
 
-    std::stable_sort(histData.begin(), histData.end(), SorterByCURRDATE());
-    Model_CurrencyHistory::Data date;
-    date.CURRDATE = dateISO;
-    auto lowerb = std::lower_bound(histData.begin(), histData.end(), date, SorterByCURRDATE());
-
-    if (lowerb == histData.end())
-        return histData.back().CURRVALUE;
-    else if (lowerb->CURRDATE == dateISO)
-        return lowerb->CURRVALUE;
-    else if (lowerb==histData.begin())
+    const DB_Date date(dateISO);
+    const auto next = std::upper_bound(rates.begin(), rates.end(), date
+        , [](const DB_Date& d, const Rate& r) { return d < r.date; });
+    if (next == rates.end())
+        return rates.back().value;
+    else if (next == rates.begin())
         return 1;
     else
-        return (lowerb-1)->CURRVALUE;
+        return (next - 1)->value;
 }
 
 void Model_CurrencyHistory::ResetCurrencyHistory()
@@ -56,9 +56,19 @@ public:
     /** Adds or updates an element in currency history */
     int addUpdate(const int& currencyID, const wxDate& date, double price, UPDTYPE type);
 
-    /** Return the rate for a specific currency in a specific day*/
+    /**
+    Return the rate for a specific currency in a specific day,
+    or the rate of the nearest day when there is none for the day itself.
+    */
     static double getDayRate(const int& currencyID, const wxString& DateISO);
     static double getDayRate(const int& currencyID, const wxDate& Date = wxDate::Today());
+    static double getDayRate(const int& currencyID, const DB_Date& date);
+
+    /**
+    Multiply each amount by the day rate of its date as getDayRate() does.
+    The rates are walked once when the amounts are sorted by date.
+    */
+    static void applyDayRate(const int& currencyID, std::vector<std::pair<DB_Date, double> >& amounts);
 
     /** Return the last rate for a specific currency */
     static double getLastRate(const int& currencyID);
@@ -67,6 +77,22 @@ public:
 
     /** Clears the currency History table */
     static void ResetCurrencyHistory();
+
+private:
+    /** The rates of a currency sorted by date, loaded once for all the currencies */
+    struct Rate
+    {
+        DB_Date date;
+        double value;
+    };
+    typedef std::vector<Rate> Timeline;
+
+    const Timeline& timeline(int currencyID);
+    static double nearest(const Timeline& rates, Timeline::const_iterator next, const DB_Date& date);
+
+    std::map<int /*currency id*/, Timeline> timelines_;
+    bool timelines_loaded_;
+    size_t timelines_revision_; // revision of the table the timelines are up to date with
 };
 
 #endif
@@ -22,6 +22,8 @@
 
 Model_CustomFieldData::Model_CustomFieldData()
 : Model<DB_Table_CUSTOMFIELDDATA>()
+, udfc_revision_(0)
+, udfc_fields_revision_(0)
 {
 }
 
@@ -39,6 +41,7 @@ Model_CustomFieldData& Model_CustomFieldData::instance(wxSQLite3Database* db)
     ins.db_ = db;
     ins.destroy_cache();
     ins.ensure(db);
+    ins.udfc_.clear();
 
     return ins;
 }
@@ -62,14 +65,19 @@ std::map<int, Model_CustomFieldData::Data_Set> Model_CustomFieldData::get_all(Mo
     const wxString& reftype_desc = Model_Attachment::reftype_desc(reftype);
     Model_CustomField::Data_Set custom_fields = Model_CustomField::instance()
         .find(Model_CustomField::DB_Table_CUSTOMFIELD::REFTYPE(reftype_desc));
-    std::map<int, Model_CustomFieldData::Data_Set> data;
+    std::vector<int> field_ids;
     for (const auto& entry : custom_fields)
-    {
-        for (const auto & custom_field : find(Model_CustomFieldData::FIELDID(entry.FIELDID)))
+        field_ids.push_back(entry.FIELDID);
+
+    std::map<int, Model_CustomFieldData::Data_Set> data;
+    if (field_ids.empty()) return data;
+
+    this->for_each([&data](const Data& r) -> bool
         {
-            data[custom_field.REFID].push_back(custom_field);
+            data[r.REFID].push_back(r);
+            return true;
         }
-    }
+        , IN_LIST<Model_CustomFieldData::FIELDID>(field_ids));
     return data;
 }
 
@@ -107,3 +115,139 @@ bool Model_CustomFieldData::DeleteAllData(const wxString& RefType, int RefID)
     this->ReleaseSavepoint();
     return true;
 }
+
+const Model_CustomFieldData::UDFC_Index& Model_CustomFieldData::get_udfc(Model_Attachment::REFTYPE reftype)
+{
+    udfc_sync(0);
+    auto it = udfc_.find(reftype);
+    if (it != udfc_.end()) return it->second;
+
+    UDFC_Index& index = udfc_[reftype];
+    const wxArrayString& names = Model_CustomField::UDFC_FIELDS();
+    std::vector<int> field_ids;
+    for (const auto& field : Model_CustomField::instance()
+        .find(Model_CustomField::DB_Table_CUSTOMFIELD::REFTYPE(Model_Attachment::reftype_desc(reftype))))
+    {
+        const int slot = names.Index(Model_CustomField::getUDFC(field.PROPERTIES)) - 1; // names[0] is no UDFC
+        if (slot < 0 || index.field_ids_[slot] >= 0) continue;
+        index.field_ids_[slot] = field.FIELDID;
+        field_ids.push_back(field.FIELDID);
+    }
+
+    // fields without a slot are not shown, nothing to load when there is none
+    if (!field_ids.empty())
+    {
+        this->for_each([&index](const Data& r) -> bool
+            {
+                index.set(r);
+                return true;
+            }
+            , IN_LIST<Model_CustomFieldData::FIELDID>(field_ids));
+    }
+    return index;
+}
+
+int Model_CustomFieldData::save(Data* r)
+{
+    Model<DB_Table_CUSTOMFIELDDATA>::save(r);
+    if (udfc_sync(1))
+    {
+        for (auto& index : udfc_) index.second.set(*r);
+    }
+    return r->id();
+}
+
+int Model_CustomFieldData::save(Data_Set& rows)
+{
+    const int count = Model<DB_Table_CUSTOMFIELDDATA>::save(rows);
+    if (static_cast<size_t>(count) != rows.size())
+        udfc_.clear();
+    else if (udfc_sync(count))
+    {
+        for (auto& index : udfc_)
+        {
+            for (const auto& r : rows) index.second.set(r);
+        }
+    }
+    return count;
+}
+
+bool Model_CustomFieldData::remove(int id)
+{
+    const bool removed = Model<DB_Table_CUSTOMFIELDDATA>::remove(id);
+    if (udfc_sync(1))
+    {
+        for (auto& index : udfc_) index.second.erase(id);
+    }
+    return removed;
+}
+
+/**
+* Check the UDFC indexes against the revisions of the data and the fields, expecting the given
+* number of changes of the data made through save() or remove(). Anything else drops the indexes.
+* Return true when the indexes are to be patched.
+*/
+bool Model_CustomFieldData::udfc_sync(size_t changes)
+{
+    const size_t fields_revision = Model_CustomField::instance().revision_;
+    if (fields_revision != udfc_fields_revision_)
+    {
+        udfc_.clear();
+        udfc_fields_revision_ = fields_revision;
+    }
+
+    if (this->revision_ == udfc_revision_) return false;
+
+    const bool patch = !udfc_.empty() && (this->revision_ == udfc_revision_ + changes);
+    if (!patch) udfc_.clear();
+    udfc_revision_ = this->revision_;
+    return patch;
+}
+
+Model_CustomFieldData::UDFC_Index::UDFC_Index()
+{
+    for (int i = 0; i < UDFC_SLOTS; ++i) field_ids_[i] = -1;
+}
+
+const wxString& Model_CustomFieldData::UDFC_Index::content(int ref_id, int slot) const
+{
+    static const wxString none;
+    if (field_ids_[slot] < 0) return none;
+
+    const auto it = contents_.find(key(ref_id, field_ids_[slot]));
+    return it == contents_.end() ? none : it->second;
+}
+
+long long Model_CustomFieldData::UDFC_Index::key(int ref_id, int field_id)
+{
+    return (static_cast<long long>(ref_id) << 32) | static_cast<unsigned int>(field_id);
+}
+
+int Model_CustomFieldData::UDFC_Index::slot(int field_id) const
+{
+    for (int i = 0; i < UDFC_SLOTS; ++i)
+    {
+        if (field_ids_[i] == field_id) return i;
+    }
+    return -1;
+}
+
+/** Store the content of the record, moving it when its REFID or FIELDID changed */
+void Model_CustomFieldData::UDFC_Index::set(const Data& r)
+{
+    erase(r.FIELDATADID);
+    if (slot(r.FIELDID) < 0) return;
+
+    const long long k = key(r.REFID, r.FIELDID);
+    contents_[k] = r.CONTENT;
+    keys_[r.FIELDATADID] = k;
+}
+
+void Model_CustomFieldData::UDFC_Index::erase(int id)
+{
+    const auto it = keys_.find(id);
+    if (it == keys_.end()) return;
+
+    contents_.erase(it->second);
+    keys_.erase(it);
+}
@@ -27,6 +27,8 @@ class Model_CustomFieldData : public Model<DB_Table_CUSTOMFIELDDATA>
 {
 public:
     using Model<DB_Table_CUSTOMFIELDDATA>::get;
+    using Model<DB_Table_CUSTOMFIELDDATA>::save;
+    using Model<DB_Table_CUSTOMFIELDDATA>::remove;
 
 public:
     Model_CustomFieldData();
@@ -52,6 +54,49 @@ public:
     Data* get(int FieldID, int RefID);
     wxArrayString allValue(const int FieldID);
     bool DeleteAllData(const wxString& RefType, int RefID);
+
+public:
+    enum { UDFC_SLOTS = 5 };
+
+    /** The contents of the UDFC01 .. UDFC05 custom fields of the records of a reference type */
+    class UDFC_Index
+    {
+    public:
+        UDFC_Index();
+        /** Return the content of the field in the slot (0 for UDFC01) of the record, empty when not set */
+        const wxString& content(int ref_id, int slot) const;
+        bool empty() const { return contents_.empty(); }
+
+    private:
+        friend class Model_CustomFieldData;
+        static long long key(int ref_id, int field_id);
+        int slot(int field_id) const;
+        void set(const Data& r);
+        void erase(int id);
+
+        int field_ids_[UDFC_SLOTS]; // FIELDID of UDFC01 .. UDFC05, -1 when not assigned
+        std::unordered_map<long long /*REFID, FIELDID*/, wxString> contents_;
+        std::unordered_map<int /*FIELDATADID*/, long long> keys_;
+    };
+
+    /**
+    * Return the UDFC contents of the reference type, loaded with one query and kept in step
+    * by save() and remove(). Other changes of the data or of the fields make it reload on next use.
+    */
+    const UDFC_Index& get_udfc(Model_Attachment::REFTYPE reftype);
+
+    /** Save the record and refresh its content in the UDFC indexes */
+    int save(Data* r);
+    int save(Data_Set& rows);
+    /** Remove the record and drop its content from the UDFC indexes */
+    bool remove(int id);
+
+private:
+    bool udfc_sync(size_t changes);
+
+    std::map<int /*REFTYPE*/, UDFC_Index> udfc_;
+    size_t udfc_revision_; // revision of the table the indexes are up to date with
+    size_t udfc_fields_revision_; // revision of Model_CustomField the indexes are up to date with
 };
 
 #endif
@@ -22,6 +22,8 @@
 
 Model_Infotable::Model_Infotable()
 : Model<DB_Table_INFOTABLE>()
+, loaded_(false)
+, dirty_(0)
 {
 }
 
@@ -40,6 +42,9 @@ Model_Infotable& Model_Infotable::instance(wxSQLite3Database* db)
     ins.destroy_cache();
     ins.ensure(db);
     ins.preload();
+    ins.values_.clear();
+    ins.loaded_ = false;
+    ins.dirty_ = 0;
     if (!ins.KeyExists("MMEXVERSION"))
     {
         ins.Set("MMEXVERSION", mmex::version::string);
@@ -67,28 +72,19 @@ void Model_Infotable::Set(const wxString& key, const wxDateTime& date)
     this->Set(key, date.FormatISODate());
 }
 
+/** The value is written by the next Flush(), on idle or when the database is closed */
 void Model_Infotable::Set(const wxString& key, const wxString& value)
 {
     if (!this->db_) return;
 
-    Data* info = this->get_one(INFONAME(key));
-    if (!info) // not cached
-    {
-        Data_Set items = this->find(INFONAME(key));
-        if (!items.empty()) info = this->get(items[0].INFOID);
-    }
-    if (info)
-    {
-        info->INFOVALUE= value;
-        info->save(this->db_);
-    }
-    else
-    {
-        info = this->create();
-        info->INFONAME = key;
-        info->INFOVALUE = value;
-        info->save(this->db_);
-    }
+    Entry* info = this->entry(key);
+    if (!info) info = &values_[key];
+    if (!info->dirty) ++dirty_;
+
+    info->value = value;
+    info->dirty = true;
+    info->parsed = false;
+    info->colour_parsed = false;
 }
 
 void Model_Infotable::Set(const wxString& key, const wxColour& value)
@@ -99,6 +95,10 @@ void Model_Infotable::Set(const wxString& key, const wxColour& value)
 //Deleter
 void Model_Infotable::Delete(const wxString& key)
 {
+    const Entry* info = this->entry(key);
+    if (info && info->dirty) --dirty_;
+    values_.erase(key);
+
     Data_Set items = this->find(INFONAME(key));
     for (const auto entry : items)
     {
@@ -109,44 +109,48 @@ void Model_Infotable::Delete(const wxString& key)
 // Getter
 bool Model_Infotable::GetBoolInfo(const wxString& key, bool default_value)
 {
-    const wxString value = this->GetStringInfo(key, "");
-    if (value == "1" || value.CmpNoCase("TRUE") == 0)
-        return true;
-    else if (value == "0" || value.CmpNoCase("FALSE") == 0)
-        return false;
-    else
-        return default_value;
+    Entry* info = this->entry(key);
+    if (!info) return default_value;
+    if (!info->parsed)
+    {
+        const wxString& value = info->value;
+        if (value == "1" || value.CmpNoCase("TRUE") == 0)
+            info->bool_value = 1;
+        else if (value == "0" || value.CmpNoCase("FALSE") == 0)
+            info->bool_value = 0;
+        else
+            info->bool_value = -1;
+        info->int_valid = !value.IsEmpty() && value.IsNumber();
+        info->int_value = info->int_valid ? wxAtoi(value) : 0;
+        info->parsed = true;
+    }
+
+    return info->bool_value < 0 ? default_value : info->bool_value == 1;
 }
 
 int Model_Infotable::GetIntInfo(const wxString& key, int default_value)
 {
-    const wxString value = this->GetStringInfo(key, "");
-    if (!value.IsEmpty() && value.IsNumber())
-        return wxAtoi(value);
+    Entry* info = this->entry(key);
+    if (!info) return default_value;
+    if (!info->parsed) GetBoolInfo(key, false);
 
-    return default_value;
+    return info->int_valid ? info->int_value : default_value;
 }
 
 wxString Model_Infotable::GetStringInfo(const wxString& key, const wxString& default_value)
 {
-    Data* info = this->get_one(INFONAME(key));
-    if (info)
-        return info->INFOVALUE;
-    else // not cached
-    {
-        Data_Set items = this->find(INFONAME(key));
-        if (!items.empty())
-            return items[0].INFOVALUE;
-    }
-
-    return default_value;
+    const Entry* info = this->entry(key);
+    return info ? info->value : default_value;
 }
 
 const wxColour Model_Infotable::GetColourSetting(const wxString& key, const wxColour& default_value)
 {
-    const wxString value = this->GetStringInfo(key, "");
-    if (!value.IsEmpty())
+    Entry* info = this->entry(key);
+    if (!info || info->value.IsEmpty()) return default_value;
+
+    if (!info->colour_parsed)
     {
+        const wxString& value = info->value;
         wxRegEx pattern("([0-9]{1,3}),([0-9]{1,3}),([0-9]{1,3})");
         if (pattern.Matches(value))
         {
@@ -154,21 +158,66 @@ const wxColour Model_Infotable::GetColourSetting(const wxString& key, const wxCo
             const wxString green = pattern.GetMatch(value, 2);
             const wxString blue = pattern.GetMatch(value, 3);
 
-            return wxColour(wxAtoi(red), wxAtoi(green), wxAtoi(blue));
+            info->colour = wxColour(wxAtoi(red), wxAtoi(green), wxAtoi(blue));
         }
         else
         {
-            return wxColor(value);
+            info->colour = wxColor(value);
         }
+        info->colour_parsed = true;
     }
 
-    return default_value;
+    return info->colour;
 }
 
 /* Returns true if key setting found */
 bool Model_Infotable::KeyExists(const wxString& key)
 {
-    return !this->find(INFONAME(key)).empty();
+    return this->entry(key) != nullptr;
+}
+
+/** Return the value, loading every value on first use; nullptr when not found */
+Model_Infotable::Entry* Model_Infotable::entry(const wxString& key)
+{
+    if (!loaded_ && this->db_)
+    {
+        for (const auto& r : this->all())
+        {
+            if (values_.count(r.INFONAME)) continue; // the first one, as get_one() did
+            Entry& info = values_[r.INFONAME];
+            info.id = r.INFOID;
+            info.value = r.INFOVALUE;
+        }
+        loaded_ = true;
+    }
+
+    const auto it = values_.find(key);
+    return it == values_.end() ? nullptr : &it->second;
+}
+
+void Model_Infotable::Flush()
+{
+    if (dirty_ == 0 || !this->db_) return;
+
+    this->Savepoint();
+    for (auto& item : values_)
+    {
+        Entry& info = item.second;
+        if (!info.dirty) continue;
+
+        Data* r = info.id > 0 ? this->get(info.id) : nullptr;
+        if (!r)
+        {
+            r = this->create();
+            r->INFONAME = item.first;
+        }
+        r->INFOVALUE = info.value;
+        r->save(this->db_);
+        info.id = r->INFOID;
+        info.dirty = false;
+    }
+    this->ReleaseSavepoint();
+    dirty_ = 0;
 }
 
 bool Model_Infotable::checkDBVersion()
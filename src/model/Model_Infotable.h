@@ -67,6 +67,7 @@ public:
     /* Check database at minimum revision*/
     bool checkDBVersion();
 
+    /* Rows of the table as written, without the values not flushed yet */
     static loop_t to_loop_t();
 
 public:
@@ -74,6 +75,32 @@ public:
     void SetOpenCustomDialog(const wxString& RefType, const bool Status);
     wxSize CustomDialogSize(const wxString& RefType);
     void SetCustomDialogSize(const wxString& RefType, const wxSize& Size);
+
+public:
+    /** Write the values changed since the last flush, in one savepoint */
+    void Flush();
+
+private:
+    /** A value held in memory, with the typed values parsed from it on first use */
+    struct Entry
+    {
+        Entry(): id(-1), dirty(false), parsed(false), bool_value(-1), int_valid(false), int_value(0), colour_parsed(false) {}
+        int id; // INFOID, -1 until written
+        wxString value;
+        bool dirty;
+        bool parsed;
+        int bool_value; // 1, 0 or -1 when not a boolean
+        bool int_valid;
+        int int_value;
+        bool colour_parsed;
+        wxColour colour;
+    };
+
+    Entry* entry(const wxString& key);
+
+    std::unordered_map<wxString, Entry> values_;
+    bool loaded_;
+    size_t dirty_;
 };
 
 #endif
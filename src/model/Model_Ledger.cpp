@@ -0,0 +1,225 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "Model_Ledger.h"
+#include "Model_Account.h"
+
+Model_Ledger& Model_Ledger::instance()
+{
+    return Singleton<Model_Ledger>::instance();
+}
+
+double Model_Ledger::balance(int account_id, VARIANT variant)
+{
+    const Ledger& l = ledger(account_id);
+    return l.entries.empty() ? 0.0 : l.entries.back().sum[variant].to_double(l.precision);
+}
+
+double Model_Ledger::balance(int account_id, const DB_Date& date, VARIANT variant)
+{
+    const Ledger& l = ledger(account_id);
+    const auto it = std::upper_bound(l.entries.begin(), l.entries.end(), date.ymd()
+        , [](int ymd, const Entry& e) { return ymd < e.ymd; });
+    return it == l.entries.begin() ? 0.0 : (it - 1)->sum[variant].to_double(l.precision);
+}
+
+double Model_Ledger::balance(int account_id, const wxDate& date, VARIANT variant)
+{
+    return balance(account_id, DB_Date(date), variant);
+}
+
+Money Model_Ledger::sum(int account_id, VARIANT variant)
+{
+    const Entries& entries = ledger(account_id).entries;
+    return entries.empty() ? Money() : entries.back().sum[variant];
+}
+
+void Model_Ledger::patch(const Model_Checking::Data* r)
+{
+    if (!sync(1)) return;
+
+    Changes changes;
+    erase(r->TRANSID, changes);
+    // the accounts found by Model_Account::transaction(), ledgers not built yet get it on first use
+    insert(r, r->ACCOUNTID, changes);
+    if (r->TOACCOUNTID != r->ACCOUNTID) insert(r, r->TOACCOUNTID, changes);
+    accumulate(changes);
+}
+
+void Model_Ledger::remove(int trans_id)
+{
+    if (!sync(1)) return;
+
+    Changes changes;
+    erase(trans_id, changes);
+    accumulate(changes);
+}
+
+void Model_Ledger::reset()
+{
+    ledgers_.clear();
+    places_.clear();
+    revision_ = Model_Checking::instance().revision_;
+}
+
+/**
+* Return the ledger of the account, building it from the database when missing or stale,
+* or when the precision of the currency of the account changed since.
+*/
+const Model_Ledger::Ledger& Model_Ledger::ledger(int account_id)
+{
+    sync(0);
+
+    const Model_Account::Data* account = Model_Account::instance().get(account_id);
+    const int precision = account ? Model_Currency::precision(Model_Account::currency(account)) : 2;
+    auto it = ledgers_.find(account_id);
+    if (it != ledgers_.end() && it->second.precision == precision) return it->second;
+
+    Ledger& ledger = ledgers_[account_id];
+    ledger.precision = precision;
+    Entries& entries = ledger.entries;
+    for (const auto& e : entries)
+        unplace(e.trans_id, account_id);
+    entries.clear();
+    if (!account) return ledger;
+
+    for (const auto& tran : Model_Account::transaction(account))
+    {
+        Entry e;
+        e.ymd = tran.TRANSDATE_YMD.ymd();
+        e.trans_id = tran.TRANSID;
+        e.amount[BALANCE] = Model_Checking::balance(tran, account_id, precision);
+        e.amount[RECONCILED] = Model_Checking::reconciled(tran, account_id, precision);
+        entries.push_back(e);
+        place(e.trans_id, e.ymd, account_id);
+    }
+    std::sort(entries.begin(), entries.end(), before); // dates not in ISO format sort first
+    accumulate(entries, 0);
+
+    return ledger;
+}
+
+/**
+* Check the ledgers against the revision of Model_Checking, expecting the given number of
+* changes made through Model_Checking::save() or remove(). Anything else resets the ledgers.
+* Return true when the ledgers are to be patched.
+*/
+bool Model_Ledger::sync(size_t changes)
+{
+    const size_t revision = Model_Checking::instance().revision_;
+    if (revision == revision_) return false;
+
+    const bool patch = (revision == revision_ + changes);
+    if (!patch)
+    {
+        ledgers_.clear();
+        places_.clear();
+    }
+    revision_ = revision;
+    return patch;
+}
+
+/** Add the entry of the transaction to the ledger of the account when it is built */
+void Model_Ledger::insert(const Model_Checking::Data* r, int account_id, Changes& changes)
+{
+    const auto it = ledgers_.find(account_id);
+    if (it == ledgers_.end()) return;
+    Ledger& ledger = it->second;
+
+    Entry e;
+    e.ymd = r->TRANSDATE_YMD.ymd();
+    e.trans_id = r->TRANSID;
+    e.amount[BALANCE] = Model_Checking::balance(r, account_id, ledger.precision);
+    e.amount[RECONCILED] = Model_Checking::reconciled(r, account_id, ledger.precision);
+
+    Entries& entries = ledger.entries;
+    const auto pos = std::upper_bound(entries.begin(), entries.end(), e, before);
+    changes.push_back(std::make_pair(account_id, static_cast<size_t>(pos - entries.begin())));
+    entries.insert(pos, e);
+    place(e.trans_id, e.ymd, account_id);
+}
+
+/** Remove the entries of the transaction from the ledgers holding them */
+void Model_Ledger::erase(int trans_id, Changes& changes)
+{
+    const auto it = places_.find(trans_id);
+    if (it == places_.end()) return;
+
+    const Place place = it->second;
+    places_.erase(it);
+    for (int account_id : place.accounts)
+    {
+        if (account_id < 0) continue;
+        Entries& entries = ledgers_[account_id].entries;
+        Entry key;
+        key.ymd = place.ymd;
+        key.trans_id = trans_id;
+        const auto pos = std::lower_bound(entries.begin(), entries.end(), key, before);
+        if (pos == entries.end() || pos->trans_id != trans_id) continue;
+
+        changes.push_back(std::make_pair(account_id, static_cast<size_t>(pos - entries.begin())));
+        entries.erase(pos);
+    }
+}
+
+void Model_Ledger::place(int trans_id, int ymd, int account_id)
+{
+    Place& place = places_.insert(std::make_pair(trans_id, Place{ ymd, { -1, -1 } })).first->second;
+    place.ymd = ymd;
+    if (place.accounts[0] == account_id || place.accounts[1] == account_id) return;
+    place.accounts[place.accounts[0] < 0 ? 0 : 1] = account_id;
+}
+
+void Model_Ledger::unplace(int trans_id, int account_id)
+{
+    const auto it = places_.find(trans_id);
+    if (it == places_.end()) return;
+
+    Place& place = it->second;
+    for (int& a : place.accounts)
+    {
+        if (a == account_id) a = -1;
+    }
+    if (place.accounts[0] < 0 && place.accounts[1] < 0) places_.erase(it);
+}
+
+/** Refresh the prefix sums of each ledger changed, once from its first change */
+void Model_Ledger::accumulate(const Changes& changes)
+{
+    std::map<int, size_t> from;
+    for (const auto& change : changes)
+    {
+        const auto it = from.insert(change).first;
+        it->second = std::min(it->second, change.second);
+    }
+    for (const auto& f : from)
+        accumulate(ledgers_[f.first].entries, f.second);
+}
+
+bool Model_Ledger::before(const Entry& x, const Entry& y)
+{
+    return x.ymd < y.ymd || (x.ymd == y.ymd && x.trans_id < y.trans_id);
+}
+
+/** Refresh the prefix sums from the position onwards */
+void Model_Ledger::accumulate(Entries& entries, size_t from)
+{
+    for (size_t i = from; i < entries.size(); ++i)
+    {
+        for (int v = 0; v < MAX_VARIANT; ++v)
+            entries[i].sum[v] = (i > 0 ? entries[i - 1].sum[v] : Money()) + entries[i].amount[v];
+    }
+}
@@ -0,0 +1,94 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include "Model_Checking.h"
+
+/**
+* Running balances of the accounts: the transactions of an account sorted by
+* TRANSDATE, TRANSID like Model_Account::transaction(), with prefix sums of
+* Model_Checking::balance() and Model_Checking::reconciled(), summed exactly in minor units
+* of the currency of the account (see Money) and rebuilt when its precision changes.
+* A ledger is built on first use, patched by Model_Checking::save() and remove(),
+* and rebuilt when the table is changed in any other way (bulk save, update_where ...).
+* The initial balance of the account is not included.
+*/
+class Model_Ledger
+{
+public:
+    enum VARIANT { BALANCE = 0, RECONCILED, MAX_VARIANT };
+
+public:
+    /** Return the static instance of the ledgers */
+    static Model_Ledger& instance();
+
+public:
+    /** Sum of the transactions of the account */
+    double balance(int account_id, VARIANT variant = BALANCE);
+    /** Sum of the transactions of the account up to and including the date */
+    double balance(int account_id, const DB_Date& date, VARIANT variant = BALANCE);
+    double balance(int account_id, const wxDate& date, VARIANT variant = BALANCE);
+    /** Sum of the transactions of the account in minor units of the currency of the account */
+    Money sum(int account_id, VARIANT variant = BALANCE);
+
+    /** Move the transaction just saved to its place in the ledgers of its accounts */
+    void patch(const Model_Checking::Data* r);
+    /** Drop the transaction just removed from the ledgers */
+    void remove(int trans_id);
+    /** Forget every ledger, they are rebuilt on next use */
+    void reset();
+
+private:
+    struct Entry
+    {
+        int ymd;
+        int trans_id;
+        Money amount[MAX_VARIANT];
+        Money sum[MAX_VARIANT]; // up to and including this entry
+    };
+    typedef std::vector<Entry> Entries;
+
+    struct Ledger
+    {
+        int precision; // of the amounts, the one of the currency of the account
+        Entries entries;
+    };
+
+    /** Where the entries of a transaction are, to find them without a scan */
+    struct Place
+    {
+        int ymd;
+        int accounts[2]; // of the ledgers built holding an entry of the transaction, -1 for none
+    };
+
+    /** First entry of a ledger whose prefix sums are to be refreshed after a patch */
+    typedef std::vector<std::pair<int /*account id*/, size_t> > Changes;
+
+    const Ledger& ledger(int account_id);
+    bool sync(size_t changes);
+    void erase(int trans_id, Changes& changes);
+    void insert(const Model_Checking::Data* r, int account_id, Changes& changes);
+    void place(int trans_id, int ymd, int account_id);
+    void unplace(int trans_id, int account_id);
+    void accumulate(const Changes& changes);
+    static void accumulate(Entries& entries, size_t from);
+    static bool before(const Entry& x, const Entry& y);
+
+    std::map<int /*account id*/, Ledger> ledgers_;
+    std::unordered_map<int /*TRANSID*/, Place> places_;
+    size_t revision_ = 0; // revision of Model_Checking the ledgers are up to date with
+};
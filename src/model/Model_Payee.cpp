@@ -64,7 +64,7 @@ const Model_Payee::Data_Set Model_Payee::FilterPayees(const wxString& payee_patt
 Model_Payee::Data* Model_Payee::get(const wxString& name)
 {
     Data* payee = this->get_one(PAYEENAME(name));
-    if (payee) return payee;
+    if (payee || this->cache_complete()) return payee;
 
     Data_Set items = this->find(PAYEENAME(name));
     if (!items.empty()) payee = this->get(items[0].PAYEEID, this->db_);
@@ -23,6 +23,8 @@
 
 Model_Setting::Model_Setting()
 : Model<DB_Table_SETTING_V1>()
+, loaded_(false)
+, dirty_(0)
 {
 }
 
@@ -41,6 +43,9 @@ Model_Setting& Model_Setting::instance(wxSQLite3Database* db)
     ins.destroy_cache();
     ins.ensure(db);
     ins.preload();
+    ins.values_.clear();
+    ins.loaded_ = false;
+    ins.dirty_ = 0;
 
     return ins;
 }
@@ -67,59 +72,91 @@ void Model_Setting::Set(const wxString& key, const wxColour& value)
     this->Set(key, wxString::Format("%d,%d,%d", value.Red(), value.Green(), value.Blue()));
 }
 
+/** The value is written by the next Flush(), on idle or on close */
 void Model_Setting::Set(const wxString& key, const wxString& value)
 {
-    Data* setting = this->get_one(SETTINGNAME(key));
-    if (!setting) // not cached
-    {
-        Data_Set items = this->find(SETTINGNAME(key));
-        if (!items.empty()) setting = this->get(items[0].SETTINGID, this->db_);
-    }
-    if (setting)
-    {
-        setting->SETTINGVALUE = value;
-        setting->save(this->db_);
-    }
-    else
-    {
-        setting = this->create();
-        setting->SETTINGNAME = key;
-        setting->SETTINGVALUE = value;
-        setting->save(this->db_);
-    }
+    Entry* setting = this->entry(key);
+    if (!setting) setting = &values_[key];
+    if (!setting->dirty) ++dirty_;
+
+    setting->value = value;
+    setting->dirty = true;
+    setting->parsed = false;
 }
 
 // Getter
 bool Model_Setting::GetBoolSetting(const wxString& key, bool default_value)
 {
-    wxString value = this->GetStringSetting(key, "");
-    if (value == "TRUE") return true;
-    if (value == "FALSE") return false;
+    Entry* setting = this->entry(key);
+    if (!setting) return default_value;
+    if (!setting->parsed)
+    {
+        setting->bool_value = setting->value == "TRUE" ? 1 : (setting->value == "FALSE" ? 0 : -1);
+        setting->int_valid = !setting->value.IsEmpty() && setting->value.IsNumber();
+        setting->int_value = setting->int_valid ? wxAtoi(setting->value) : 0;
+        setting->parsed = true;
+    }
 
-    return default_value;
+    return setting->bool_value < 0 ? default_value : setting->bool_value == 1;
 }
 
 int Model_Setting::GetIntSetting(const wxString& key, int default_value)
 {
-    wxString value = this->GetStringSetting(key, "");
-    if (!value.IsEmpty() && value.IsNumber()) return wxAtoi(value);
+    Entry* setting = this->entry(key);
+    if (!setting) return default_value;
+    if (!setting->parsed) GetBoolSetting(key, false);
 
-    return default_value;
+    return setting->int_valid ? setting->int_value : default_value;
 }
 
 wxString Model_Setting::GetStringSetting(const wxString& key, const wxString& default_value)
 {
-    Data* setting = this->get_one(SETTINGNAME(key));
-    if (!setting) // not cached
+    const Entry* setting = this->entry(key);
+    return setting ? setting->value : default_value;
+}
+
+/** Return the setting, loading every setting on first use; nullptr when not found */
+Model_Setting::Entry* Model_Setting::entry(const wxString& key)
+{
+    if (!loaded_)
     {
-        Data_Set items = this->find(SETTINGNAME(key));
-        if (!items.empty()) return items[0].SETTINGVALUE;
+        for (const auto& r : this->all())
+        {
+            if (values_.count(r.SETTINGNAME)) continue; // the first one, as get_one() did
+            Entry& setting = values_[r.SETTINGNAME];
+            setting.id = r.SETTINGID;
+            setting.value = r.SETTINGVALUE;
+        }
+        loaded_ = true;
     }
-    else
+
+    const auto it = values_.find(key);
+    return it == values_.end() ? nullptr : &it->second;
+}
+
+void Model_Setting::Flush()
+{
+    if (dirty_ == 0 || !this->db_) return;
+
+    this->Savepoint();
+    for (auto& item : values_)
     {
-        return setting->SETTINGVALUE;
+        Entry& setting = item.second;
+        if (!setting.dirty) continue;
+
+        Data* r = setting.id > 0 ? this->get(setting.id, this->db_) : nullptr;
+        if (!r)
+        {
+            r = this->create();
+            r->SETTINGNAME = item.first;
+        }
+        r->SETTINGVALUE = setting.value;
+        r->save(this->db_);
+        setting.id = r->SETTINGID;
+        setting.dirty = false;
     }
-    return default_value;
+    this->ReleaseSavepoint();
+    dirty_ = 0;
 }
 
 wxString Model_Setting::getLastDbPath()
@@ -147,14 +184,15 @@ wxString Model_Setting::getLastDbPath()
 /* Returns true if key setting found */
 bool Model_Setting::ContainsSetting(const wxString& key)
 {
-    return !this->find(SETTINGNAME(key)).empty();
+    return this->entry(key) != nullptr;
 }
 
 row_t Model_Setting::to_row_t()
 {
     row_t row;
-    for (const auto &r: instance().all())
-        row(r.SETTINGNAME.ToStdWstring()) = r.SETTINGVALUE;
+    instance().entry(""); // load the settings
+    for (const auto &r: instance().values_)
+        row(r.first.ToStdWstring()) = r.second.value;
     return row;
 }
 
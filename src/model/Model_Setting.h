@@ -84,6 +84,30 @@ public:
     void SetViewTransactions(const wxString& value);
 
     void ShrinkUsageTable();
+
+public:
+    /** Write the settings changed since the last flush, in one savepoint */
+    void Flush();
+
+private:
+    /** A setting held in memory, with the typed values parsed from it on first use */
+    struct Entry
+    {
+        Entry(): id(-1), dirty(false), parsed(false), bool_value(-1), int_valid(false), int_value(0) {}
+        int id; // SETTINGID, -1 until written
+        wxString value;
+        bool dirty;
+        bool parsed;
+        int bool_value; // 1, 0 or -1 when not a boolean
+        bool int_valid;
+        int int_value;
+    };
+
+    Entry* entry(const wxString& key);
+
+    std::unordered_map<wxString, Entry> values_;
+    bool loaded_;
+    size_t dirty_;
 };
 
 #endif
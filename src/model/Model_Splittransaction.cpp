@@ -19,9 +19,13 @@
 #include "Model_Splittransaction.h"
 #include "Model_Category.h"
 #include "Model_Subcategory.h"
+#include "Model_CategoryCube.h"
+#include <algorithm>
 
 Model_Splittransaction::Model_Splittransaction()
 : Model<DB_Table_SPLITTRANSACTIONS>()
+, index_loaded_(false)
+, index_revision_(0)
 {
 }
 
@@ -39,6 +43,8 @@ Model_Splittransaction& Model_Splittransaction::instance(wxSQLite3Database* db)
     ins.db_ = db;
     ins.destroy_cache();
     ins.ensure(db);
+    ins.index_.clear();
+    ins.index_loaded_ = false;
 
     return ins;
 }
@@ -62,16 +68,6 @@ double Model_Splittransaction::get_total(const std::vector<Split>& rows)
     return total;
 }
 
-std::map<int, Model_Splittransaction::Data_Set> Model_Splittransaction::get_all()
-{
-    std::map<int, Model_Splittransaction::Data_Set> data;
-    for (const auto &split : instance().all())
-    {
-        data[split.TRANSID].push_back(split);
-    }
-    return data;
-}
-
 int Model_Splittransaction::update(const Data_Set& rows, int transactionID)
 {
 
@@ -98,6 +94,153 @@ int Model_Splittransaction::update(const Data_Set& rows, int transactionID)
     return rows.size();
 }
 
+const Model_Splittransaction::Index& Model_Splittransaction::get_all()
+{
+    index_sync(0);
+    if (!index_loaded_)
+    {
+        index_.clear();
+        this->for_each([this](const Data& r) -> bool
+            {
+                index_.push_back(r);
+                return true;
+            }
+            , ORDER_BY<DB_Table_SPLITTRANSACTIONS::TRANSID>()
+            , ORDER_BY<DB_Table_SPLITTRANSACTIONS::SPLITTRANSID>());
+        index_loaded_ = true;
+    }
+    return index_;
+}
+
+int Model_Splittransaction::save(Data* r)
+{
+    Model<DB_Table_SPLITTRANSACTIONS>::save(r);
+    if (index_sync(1))
+    {
+        index_.erase(r->SPLITTRANSID);
+        index_.insert(*r);
+    }
+    Model_CategoryCube::instance().patch_splits({ r->TRANSID });
+    return r->id();
+}
+
+int Model_Splittransaction::save(Data_Set& rows)
+{
+    const int count = Model<DB_Table_SPLITTRANSACTIONS>::save(rows);
+    if (static_cast<size_t>(count) != rows.size())
+        index_loaded_ = false;
+    else if (index_sync(count))
+    {
+        for (const auto& r : rows)
+        {
+            index_.erase(r.SPLITTRANSID);
+            index_.insert(r);
+        }
+    }
+
+    std::vector<int> trans_ids;
+    for (const auto& r : rows) trans_ids.push_back(r.TRANSID);
+    std::sort(trans_ids.begin(), trans_ids.end());
+    trans_ids.erase(std::unique(trans_ids.begin(), trans_ids.end()), trans_ids.end());
+    Model_CategoryCube::instance().patch_splits(trans_ids, rows.size());
+    return count;
+}
+
+bool Model_Splittransaction::remove(int id)
+{
+    const Data* r = this->get(id);
+    const int trans_id = r ? r->TRANSID : -1;
+    const bool removed = Model<DB_Table_SPLITTRANSACTIONS>::remove(id);
+    if (index_sync(1)) index_.erase(id);
+    Model_CategoryCube::instance().patch_splits({ trans_id });
+    return removed;
+}
+
+/**
+* Check the index against the revision of the table, expecting the given number of
+* changes made through save() or remove(). Anything else drops the index.
+* Return true when the index is to be patched.
+*/
+bool Model_Splittransaction::index_sync(size_t changes)
+{
+    if (this->revision_ == index_revision_) return false;
+
+    const bool patch = index_loaded_ && (this->revision_ == index_revision_ + changes);
+    if (!patch) index_loaded_ = false;
+    index_revision_ = this->revision_;
+    return patch;
+}
+
+Model_Splittransaction::Index::Index()
+: offsets_(1, 0)
+{
+}
+
+Model_Splittransaction::Index::Range Model_Splittransaction::Index::operator[](int trans_id) const
+{
+    Range range = { 0, 0 };
+    const auto it = std::lower_bound(trans_ids_.begin(), trans_ids_.end(), trans_id);
+    if (it == trans_ids_.end() || *it != trans_id) return range;
+
+    const size_t i = it - trans_ids_.begin();
+    range.first = rows_.data() + offsets_[i];
+    range.last = rows_.data() + offsets_[i + 1];
+    return range;
+}
+
+void Model_Splittransaction::Index::clear()
+{
+    rows_.clear();
+    trans_ids_.clear();
+    offsets_.assign(1, 0);
+}
+
+/** Append a record, the records are pushed in TRANSID, SPLITTRANSID order */
+void Model_Splittransaction::Index::push_back(const Data& r)
+{
+    if (trans_ids_.empty() || trans_ids_.back() != r.TRANSID)
+    {
+        trans_ids_.push_back(r.TRANSID);
+        offsets_.push_back(offsets_.back());
+    }
+    rows_.push_back(r);
+    ++offsets_.back();
+}
+
+void Model_Splittransaction::Index::insert(const Data& r)
+{
+    const size_t i = std::lower_bound(trans_ids_.begin(), trans_ids_.end(), r.TRANSID) - trans_ids_.begin();
+    if (i == trans_ids_.size() || trans_ids_[i] != r.TRANSID)
+    {
+        trans_ids_.insert(trans_ids_.begin() + i, r.TRANSID);
+        offsets_.insert(offsets_.begin() + i, offsets_[i]);
+    }
+
+    const auto at = std::upper_bound(rows_.begin() + offsets_[i], rows_.begin() + offsets_[i + 1], r
+        , [](const Data& x, const Data& y) { return x.SPLITTRANSID < y.SPLITTRANSID; });
+    rows_.insert(at, r);
+    for (size_t j = i + 1; j < offsets_.size(); ++j) ++offsets_[j];
+}
+
+/** Remove the record, return false when it is not in the index */
+bool Model_Splittransaction::Index::erase(int split_id)
+{
+    const auto it = std::find_if(rows_.begin(), rows_.end()
+        , [split_id](const Data& r) { return r.SPLITTRANSID == split_id; });
+    if (it == rows_.end()) return false;
+
+    const size_t pos = it - rows_.begin();
+    const size_t i = std::upper_bound(offsets_.begin(), offsets_.end(), pos) - offsets_.begin() - 1;
+    rows_.erase(it);
+    for (size_t j = i + 1; j < offsets_.size(); ++j) --offsets_[j];
+    if (offsets_[i] == offsets_[i + 1])
+    {
+        trans_ids_.erase(trans_ids_.begin() + i);
+        offsets_.erase(offsets_.begin() + i);
+    }
+    return true;
+}
+
 const wxString Model_Splittransaction::get_tooltip(const std::vector<Split>& rows, const Model_Currency::Data* currency)
 {
     wxString split_tooltip = "";
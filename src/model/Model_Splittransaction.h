@@ -32,6 +32,10 @@ struct Split
 
 class Model_Splittransaction : public Model<DB_Table_SPLITTRANSACTIONS>
 {
+public:
+    using Model<DB_Table_SPLITTRANSACTIONS>::save;
+    using Model<DB_Table_SPLITTRANSACTIONS>::remove;
+
 public:
     Model_Splittransaction();
     ~Model_Splittransaction();
@@ -55,8 +59,63 @@ public:
     static double get_total(const Data_Set& rows);
     static double get_total(const std::vector<Split>& local_splits);
     static const wxString get_tooltip(const std::vector<Split>& local_splits, const Model_Currency::Data* currency);
-    std::map<int, Model_Splittransaction::Data_Set> get_all();
     int update(const Data_Set& rows, int transactionID);
+
+public:
+    /**
+    * The splits of every transaction in one flat array ordered by TRANSID, SPLITTRANSID,
+    * with the offset of the first split of each transaction.
+    */
+    class Index
+    {
+    public:
+        /** The splits of one transaction, borrowed from the index */
+        struct Range
+        {
+            const Data* first;
+            const Data* last;
+            const Data* begin() const { return first; }
+            const Data* end() const { return last; }
+            bool empty() const { return first == last; }
+            size_t size() const { return last - first; }
+        };
+
+        Index();
+        /** Return the splits of the transaction, an empty range when it has none */
+        Range operator[](int trans_id) const;
+        size_t size() const { return rows_.size(); }
+
+    private:
+        friend class Model_Splittransaction;
+        void clear();
+        void push_back(const Data& r);
+        void insert(const Data& r);
+        bool erase(int split_id);
+
+        std::vector<Data> rows_;
+        std::vector<int> trans_ids_; // distinct, sorted
+        std::vector<size_t> offsets_; // first row of trans_ids_[i], then rows_.size()
+    };
+
+    /**
+    * Return the splits of all the transactions, loaded once and kept in step by save(), remove()
+    * and update(). Other changes of the table make it reload on next use.
+    * The index and its ranges are only valid until the table changes.
+    */
+    const Index& get_all();
+
+    /** Save the record and move it to its place in the index */
+    int save(Data* r);
+    int save(Data_Set& rows);
+    /** Remove the record and drop it from the index */
+    bool remove(int id);
+
+private:
+    bool index_sync(size_t changes);
+
+    Index index_;
+    bool index_loaded_;
+    size_t index_revision_; // revision of the table the index is up to date with
 };
 
 #endif
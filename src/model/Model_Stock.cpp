@@ -104,14 +104,11 @@ Returns the last price date of a given stock
 */
 wxString Model_Stock::lastPriceDate(const Self::Data* entity)
 {
-    wxString dtStr = entity->PURCHASEDATE;
-    Model_StockHistory::Data_Set histData = Model_StockHistory::instance().find(SYMBOL(entity->SYMBOL));
+    const Model_StockHistory::Series& series = Model_StockHistory::instance().series(entity->SYMBOL);
+    if (series.dates.empty())
+        return entity->PURCHASEDATE;
 
-    std::sort(histData.begin(), histData.end(), SorterByDATE());
-    if (!histData.empty())
-        dtStr = histData.back().DATE;
-
-    return dtStr;
+    return series.dates.back().to_date().FormatISODate();
 }
 
 /**
@@ -119,66 +116,68 @@ Returns the total stock balance at a given date
 */
 double Model_Stock::getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date)
 {
-    wxString strDate = date.FormatISODate();
-    std::map<int, double> totBalance;
+    return getDailyBalanceAt(account, std::vector<wxDate>(1, date)).front();
+}
 
-    Data_Set stocks = this->instance().find(HELDAT(account->id()));
-    for (const auto & stock : stocks)
-    {
-        wxString precValueDate, nextValueDate;
-        Model_StockHistory::Data_Set stock_hist = Model_StockHistory::instance().find(SYMBOL(stock.SYMBOL));
-        std::stable_sort(stock_hist.begin(), stock_hist.end(), SorterByDATE());
-        std::reverse(stock_hist.begin(), stock_hist.end());
+/**
+The value of a share at a date is the price of that date, or else the last price before it,
+provided it is not older than the purchase (the purchase price stands in when there is none)
+and either a later price exists or the account is still open.
+*/
+std::vector<double> Model_Stock::getDailyBalanceAt(const Model_Account::Data *account, const std::vector<wxDate>& dates)
+{
+    std::vector<double> balances(dates.size(), 0.0);
+    const bool open = Model_Account::status(account) == Model_Account::OPEN;
 
-        double valueAtDate = 0.0,  precValue = 0.0, nextValue = 0.0;
+    std::vector<DB_Date> days;
+    days.reserve(dates.size());
+    for (const auto& date : dates)
+        days.push_back(DB_Date(date));
 
-        for (const auto & hist : stock_hist)
-        {
-            // test for the date requested
-            if (hist.DATE == strDate)
-            {
-                valueAtDate = hist.VALUE;
-                break;
-            }
-            // if not found, search for previous and next date
-            if (precValue == 0.0 && hist.DATE < strDate)
-            {
-                precValue = hist.VALUE;
-                precValueDate = hist.DATE;
-            }
-            if (hist.DATE > strDate)
-            {
-                nextValue = hist.VALUE;
-                nextValueDate = hist.DATE;
-            }
-            // end conditions: prec value assigned and price date < requested date
-            if (precValue != 0.0 && hist.DATE < strDate)
-                break;
-        }
-        if (valueAtDate == 0.0)
+    for (const auto& stock : find(HELDAT(account->id())))
+    {
+        const Model_StockHistory::Series& series = Model_StockHistory::instance().series(stock.SYMBOL);
+        const size_t count = series.dates.size();
+        const DB_Date purchase_date = stock.PURCHASEDATE_YMD;
+
+        size_t next = 0; // first price after the date
+        DB_Date previous;
+        for (size_t d = 0; d < days.size(); d++)
         {
-            //  if previous not found but if the given date is after purchase date, takes purchase price
-            if (precValue == 0.0 && date >= PURCHASEDATE(stock))
+            const DB_Date& day = days[d];
+            if (day < previous)
+                next = 0;
+            while (next < count && series.dates[next] <= day)
+                ++next;
+            previous = day;
+
+            double value = 0.0;
+            if (next > 0 && series.dates[next - 1] == day)
             {
-                precValue = stock.PURCHASEPRICE;
-                precValueDate = stock.PURCHASEDATE;
+                value = series.prices[next - 1];
             }
-            //  if next not found and the accoung is open, takes previous date
-            if (nextValue == 0.0 && Model_Account::status(account) == Model_Account::OPEN)
+            else
             {
-                nextValue = precValue;
-                nextValueDate = precValueDate;
+                DB_Date prec_date;
+                double prec_value = 0.0;
+                if (next > 0)
+                {
+                    prec_date = series.dates[next - 1];
+                    prec_value = series.prices[next - 1];
+                }
+                else if (day >= purchase_date)
+                {
+                    prec_date = purchase_date;
+                    prec_value = stock.PURCHASEPRICE;
+                }
+
+                if (prec_value > 0.0 && prec_date >= purchase_date && (next < count || open))
+                    value = prec_value;
             }
-            if (precValue > 0.0 && nextValue > 0.0 && precValueDate >= stock.PURCHASEDATE && nextValueDate >= stock.PURCHASEDATE)
-                valueAtDate = precValue;
-        }
 
-        totBalance[stock.id()] += stock.NUMSHARES * valueAtDate;
+            balances[d] += stock.NUMSHARES * value;
+        }
     }
 
-    double balance = 0.0;
-    for (const auto& it : totBalance)
-        balance += it.second;
-
-    return balance;
+    return balances;
 }
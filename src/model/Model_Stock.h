@@ -73,6 +73,12 @@ public:
     Returns the total stock balance at a given date
     */
     double getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date);
+
+    /**
+    Returns the total stock balance at each of the dates, in one pass over
+    the price series of every stock when the dates are sorted
+    */
+    std::vector<double> getDailyBalanceAt(const Model_Account::Data *account, const std::vector<wxDate>& dates);
 };
 
 #endif
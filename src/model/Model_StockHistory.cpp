@@ -20,6 +20,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 Model_StockHistory::Model_StockHistory()
 : Model<DB_Table_STOCKHISTORY>()
+, series_loaded_(false)
+, series_revision_(0)
 {
 };
 
@@ -36,6 +38,8 @@ Model_StockHistory& Model_StockHistory::instance(wxSQLite3Database* db)
     Model_StockHistory& ins = Singleton<Model_StockHistory>::instance();
     ins.db_ = db;
     ins.ensure(db);
+    ins.series_.clear();
+    ins.series_loaded_ = false;
 
     return ins;
 }
@@ -78,5 +82,73 @@ int Model_StockHistory::addUpdate(const wxString& symbol, const wxDate& date, do
     stockHist->DATE = date.FormatISODate();
     stockHist->VALUE = price;
     stockHist->UPDTYPE = type;
-    return save(stockHist);
+    const size_t revision = this->revision_;
+    save(stockHist);
+
+    // keep the series of the symbol in step, unless it is stale anyway
+    if (series_loaded_ && series_revision_ == revision && this->revision_ == revision + 1)
+    {
+        const DB_Date day(date);
+        Series& s = series_[symbol];
+        const size_t i = std::lower_bound(s.dates.begin(), s.dates.end(), day) - s.dates.begin();
+        if (i < s.dates.size() && s.dates[i] == day)
+        {
+            s.dates.erase(s.dates.begin() + i);
+            s.prices.erase(s.prices.begin() + i);
+        }
+        if (day.is_valid() && price != 0.0)
+        {
+            s.dates.insert(s.dates.begin() + i, day);
+            s.prices.insert(s.prices.begin() + i, price);
+        }
+        series_revision_ = this->revision_;
+    }
+    return stockHist->id();
+}
+
+const Model_StockHistory::Series& Model_StockHistory::series(const wxString& symbol)
+{
+    if (!series_loaded_ || series_revision_ != this->revision_)
+    {
+        series_.clear();
+        this->for_each([this](const Data& r) -> bool
+            {
+                if (!r.DATE_YMD.is_valid() || r.VALUE == 0.0) return true;
+                Series& s = series_[r.SYMBOL];
+                if (!s.dates.empty() && s.dates.back() == r.DATE_YMD)
+                {
+                    s.prices.back() = r.VALUE; // the last one saved for the day
+                    return true;
+                }
+                s.dates.push_back(r.DATE_YMD);
+                s.prices.push_back(r.VALUE);
+                return true;
+            }
+            , ORDER_BY<DB_Table_STOCKHISTORY::SYMBOL>()
+            , ORDER_BY<DB_Table_STOCKHISTORY::DATE>()
+            , ORDER_BY<DB_Table_STOCKHISTORY::HISTID>());
+        series_loaded_ = true;
+        series_revision_ = this->revision_;
+    }
+
+    return series_[symbol];
+}
+
+double Model_StockHistory::getLastPrice(const wxString& symbol, const DB_Date& date)
+{
+    const Series& s = series(symbol);
+    const size_t i = std::upper_bound(s.dates.begin(), s.dates.end(), date) - s.dates.begin();
+    return i > 0 ? s.prices[i - 1] : 0.0;
+}
+
+double Model_StockHistory::getNearestPrice(const wxString& symbol, const DB_Date& date)
+{
+    const Series& s = series(symbol);
+    if (s.dates.empty()) return 0.0;
+
+    const size_t i = std::upper_bound(s.dates.begin(), s.dates.end(), date) - s.dates.begin();
+    if (i == 0) return s.prices.front();
+    if (i == s.dates.size() || s.dates[i - 1] == date) return s.prices[i - 1];
+    return (date.days() - s.dates[i - 1].days()) <= (s.dates[i].days() - date.days())
+        ? s.prices[i - 1] : s.prices[i];
 }
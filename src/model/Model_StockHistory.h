@@ -56,6 +56,26 @@ public:
     Adds or updates an element in stock history
     */
     int addUpdate(const wxString& symbol, const wxDate& date, double price, UPDTYPE type);
+
+public:
+    /** The prices of a symbol sorted by date, in contiguous arrays. A zero price is no price. */
+    struct Series
+    {
+        std::vector<DB_Date> dates;
+        std::vector<double> prices;
+    };
+
+    /** Return the price series of the symbol, loading the series of every symbol once */
+    const Series& series(const wxString& symbol);
+    /** Return the last price known on or before the date, 0 when none */
+    double getLastPrice(const wxString& symbol, const DB_Date& date);
+    /** Return the price of the date, or else of the nearest date, the earlier one on a tie; 0 when none */
+    double getNearestPrice(const wxString& symbol, const DB_Date& date);
+
+private:
+    std::map<wxString, Series> series_;
+    bool series_loaded_;
+    size_t series_revision_; // revision of the table the series are up to date with
 };
 
 #endif
@@ -55,7 +55,7 @@ Model_Subcategory::Data* Model_Subcategory::get(const wxString& name, int catego
 {
     //FIXME: return wrong value
     Data* category = this->get_one(SUBCATEGNAME(name), CATEGID(category_id));
-    if (category) return category;
+    if (category || this->cache_complete()) return category;
 
     Data_Set items = this->find(SUBCATEGNAME(name), CATEGID(category_id));
     if (!items.empty()) category = this->get(items[0].SUBCATEGID, this->db_);
@@ -207,7 +207,7 @@ void Model_Translink::UpdateAssetValue(Model_Asset::Data* asset_entry)
             if (!Model_Checking::foreignTransactionAsTransfer(*asset_trans))
             {
                 Model_Currency::Data* asset_currency = Model_Account::currency(Model_Account::instance().get(asset_trans->ACCOUNTID));
-                const double conv_rate = Model_CurrencyHistory::getDayRate(asset_currency->CURRENCYID, asset_trans->TRANSDATE);
+                const double conv_rate = Model_CurrencyHistory::getDayRate(asset_currency->CURRENCYID, asset_trans->TRANSDATE_YMD);
 
                 if (asset_trans->TRANSCODE == Model_Checking::all_type()[Model_Checking::DEPOSIT])
                 {
@@ -0,0 +1,73 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include <cmath>
+
+/**
+* An amount of money as a whole number of minor units (cents for a precision of 2),
+* so that sums and differences are exact whatever the number of terms.
+* The precision is the one of the currency, see Model_Currency::precision(): it is not
+* kept in the value, the amounts added together must share it.
+* The database and the screens keep using doubles, converted with Money(value, precision)
+* and to_double(precision).
+*/
+class Money
+{
+public:
+    enum { MAX_PRECISION = 9 };
+
+public:
+    Money() : units_(0) {}
+    /** The value rounded to the nearest minor unit */
+    Money(double value, int precision) : units_(std::llround(value * scale(precision))) {}
+
+    static Money from_units(long long units)
+    {
+        Money m;
+        m.units_ = units;
+        return m;
+    }
+
+    long long units() const { return units_; }
+    double to_double(int precision) const { return static_cast<double>(units_) / scale(precision); }
+
+    /** Minor units in a major unit, the precision taken within 0 .. MAX_PRECISION */
+    static long long scale(int precision)
+    {
+        static const long long scales[MAX_PRECISION + 1] =
+        { 1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL };
+        return scales[precision < 0 ? 0 : (precision > MAX_PRECISION ? MAX_PRECISION : precision)];
+    }
+
+public:
+    Money& operator += (const Money& r) { units_ += r.units_; return *this; }
+    Money& operator -= (const Money& r) { units_ -= r.units_; return *this; }
+    Money operator - () const { return from_units(-units_); }
+    Money operator + (const Money& r) const { return from_units(units_ + r.units_); }
+    Money operator - (const Money& r) const { return from_units(units_ - r.units_); }
+
+    bool operator == (const Money& r) const { return units_ == r.units_; }
+    bool operator != (const Money& r) const { return units_ != r.units_; }
+    bool operator < (const Money& r) const { return units_ < r.units_; }
+    bool operator > (const Money& r) const { return units_ > r.units_; }
+    bool operator <= (const Money& r) const { return units_ <= r.units_; }
+    bool operator >= (const Money& r) const { return units_ >= r.units_; }
+
+private:
+    long long units_;
+};
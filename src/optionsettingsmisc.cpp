@@ -202,9 +202,7 @@ void OptionSettingsMisc::SaveStocksUrl()
     }
     else
     {
-        Model_Infotable::Data_Set items = Model_Infotable::instance().find(Model_Infotable::INFONAME("STOCKURL"));
-        if (!items.empty())
-            Model_Infotable::instance().remove(items[0].INFOID);
+        Model_Infotable::instance().Delete("STOCKURL");
     }
 }
 
@@ -172,66 +172,29 @@ void relocateCategoryDialog::OnOk(wxCommandEvent& WXUNUSED(event))
 
     if (wxMessageBox(_("Please Confirm:"), _("Category Relocation Confirmation"), wxOK | wxCANCEL) == wxOK)
     {
-        auto transactions = Model_Checking::instance()
-            .find(Model_Checking::CATEGID(m_sourceCatID)
-                , Model_Checking::SUBCATEGID(m_sourceSubCatID));
-        auto checking_split = Model_Splittransaction::instance()
-            .find(Model_Splittransaction::CATEGID(m_sourceCatID)
-                , Model_Splittransaction::SUBCATEGID(m_sourceSubCatID));
-        auto billsdeposits = Model_Billsdeposits::instance()
-            .find(Model_Billsdeposits::CATEGID(m_sourceCatID)
-                , Model_Billsdeposits::SUBCATEGID(m_sourceSubCatID));
-        auto budget = Model_Budget::instance()
-            .find(Model_Budget::CATEGID(m_sourceCatID)
-                , Model_Budget::SUBCATEGID(m_sourceSubCatID));
-        auto budget_split = Model_Budgetsplittransaction::instance()
-            .find(Model_Budgetsplittransaction::CATEGID(m_sourceCatID)
-                , Model_Budgetsplittransaction::SUBCATEGID(m_sourceSubCatID));
-        auto payees = Model_Payee::instance()
-            .find(Model_Payee::CATEGID(m_sourceCatID)
-                , Model_Payee::SUBCATEGID(m_sourceSubCatID));
-
-        for (auto &entry : transactions)
-        {
-            entry.CATEGID = m_destCatID;
-            entry.SUBCATEGID = m_destSubCatID;
-        }
-        m_changedRecords += Model_Checking::instance().save(transactions);
-
-        for (auto &entry : billsdeposits)
-        {
-            entry.CATEGID = m_destCatID;
-            entry.SUBCATEGID = m_destSubCatID;
-        }
-        m_changedRecords += Model_Billsdeposits::instance().save(billsdeposits);
-
-        for (auto &entry : checking_split)
-        {
-            entry.CATEGID = m_destCatID;
-            entry.SUBCATEGID = m_destSubCatID;
-        }
-        m_changedRecords += Model_Splittransaction::instance().save(checking_split);
-
-        for (auto &entry : payees)
-        {
-            entry.CATEGID = m_destCatID;
-            entry.SUBCATEGID = m_destSubCatID;
-        }
-        m_changedRecords += Model_Payee::instance().save(payees);
+        m_changedRecords += Model_Checking::instance().update_where(
+            SET<Model_Checking::CATEGID>(m_destCatID), SET<Model_Checking::SUBCATEGID>(m_destSubCatID)
+            , Model_Checking::CATEGID(m_sourceCatID), Model_Checking::SUBCATEGID(m_sourceSubCatID));
+
+        m_changedRecords += Model_Billsdeposits::instance().update_where(
+            SET<Model_Billsdeposits::CATEGID>(m_destCatID), SET<Model_Billsdeposits::SUBCATEGID>(m_destSubCatID)
+            , Model_Billsdeposits::CATEGID(m_sourceCatID), Model_Billsdeposits::SUBCATEGID(m_sourceSubCatID));
+
+        m_changedRecords += Model_Splittransaction::instance().update_where(
+            SET<Model_Splittransaction::CATEGID>(m_destCatID), SET<Model_Splittransaction::SUBCATEGID>(m_destSubCatID)
+            , Model_Splittransaction::CATEGID(m_sourceCatID), Model_Splittransaction::SUBCATEGID(m_sourceSubCatID));
+
+        m_changedRecords += Model_Payee::instance().update_where(
+            SET<Model_Payee::CATEGID>(m_destCatID), SET<Model_Payee::SUBCATEGID>(m_destSubCatID)
+            , Model_Payee::CATEGID(m_sourceCatID), Model_Payee::SUBCATEGID(m_sourceSubCatID));
         mmWebApp::MMEX_WebApp_UpdatePayee();
 
-        for (auto &entry : budget_split)
-        {
-            entry.CATEGID = m_destCatID;
-            entry.SUBCATEGID = m_destSubCatID;
-        }
-        m_changedRecords += Model_Budgetsplittransaction::instance().save(budget_split);
-
-        for (auto &entry : budget)
-        {
-            Model_Budget::instance().remove(entry.BUDGETENTRYID);
-            m_changedRecords++;
-        }
+        m_changedRecords += Model_Budgetsplittransaction::instance().update_where(
+            SET<Model_Budgetsplittransaction::CATEGID>(m_destCatID), SET<Model_Budgetsplittransaction::SUBCATEGID>(m_destSubCatID)
+            , Model_Budgetsplittransaction::CATEGID(m_sourceCatID), Model_Budgetsplittransaction::SUBCATEGID(m_sourceSubCatID));
+
+        m_changedRecords += Model_Budget::instance().remove_where(
+            Model_Budget::CATEGID(m_sourceCatID), Model_Budget::SUBCATEGID(m_sourceSubCatID));
 
         EndModal(wxID_OK);
     }
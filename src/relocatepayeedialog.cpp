@@ -158,17 +158,11 @@ void relocatePayeeDialog::OnOk(wxCommandEvent& WXUNUSED(event))
 
     if (ans == wxOK)
     {
-        auto transactions = Model_Checking::instance().find(Model_Checking::PAYEEID(sourcePayeeID_));
-        for (auto &entry : transactions) {
-            entry.PAYEEID = destPayeeID_;
-        }
-        m_changed_records += Model_Checking::instance().save(transactions);
+        m_changed_records += Model_Checking::instance().update_where(
+            SET<Model_Checking::PAYEEID>(destPayeeID_), Model_Checking::PAYEEID(sourcePayeeID_));
 
-        auto billsdeposits = Model_Billsdeposits::instance().find(Model_Billsdeposits::PAYEEID(sourcePayeeID_));
-        for (auto &entry : billsdeposits) {
-            entry.PAYEEID = destPayeeID_;
-        }
-        m_changed_records += Model_Billsdeposits::instance().save(billsdeposits);
+        m_changed_records += Model_Billsdeposits::instance().update_where(
+            SET<Model_Billsdeposits::PAYEEID>(destPayeeID_), Model_Billsdeposits::PAYEEID(sourcePayeeID_));
 
         if (cbDelete_->IsChecked())
         {
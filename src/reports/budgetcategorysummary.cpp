@@ -111,7 +111,7 @@ wxString mmReportBudgetCategorySummary::getHTMLText()
     std::map<int, std::map<int, Model_Budget::PERIOD_ENUM> > budgetPeriod;
     std::map<int, std::map<int, double> > budgetAmt;
     Model_Budget::instance().getBudgetEntry(m_date_selection, budgetPeriod, budgetAmt);
-    std::map<int, std::map<int, std::map<int, double> > > categoryStats;
+    Model_Category::Stats categoryStats;
     Model_Category::instance().getCategoryStats(categoryStats
         , nullptr
         , &date_range, Option::instance().getIgnoreFutureTransactions()
@@ -164,7 +164,7 @@ wxString mmReportBudgetCategorySummary::getHTMLText()
                         , budgetAmt[category.second.first][category.second.second])
                     : Model_Budget::getYearlyEstimate(budgetPeriod[category.second.first][category.second.second]
                         , budgetAmt[category.second.first][category.second.second]));
-                double actual = categoryStats[category.second.first][category.second.second][0];
+                double actual = categoryStats(category.second.first, category.second.second, 0);
 
                 ValueTrio vt;
                 vt.label = category.first;
@@ -205,7 +205,7 @@ wxString mmReportBudgetCategorySummary::getHTMLText()
         else
             estIncome += estimated;
 
-        double actual = categoryStats[category.second.first][category.second.second][0];
+        double actual = categoryStats(category.second.first, category.second.second, 0);
         if (actual < 0)
             actExpenses += actual;
         else
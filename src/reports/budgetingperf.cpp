@@ -129,7 +129,7 @@ wxString mmReportBudgetingPerformance::getHTMLText()
     std::map<int, std::map<int, Model_Budget::PERIOD_ENUM> > budgetPeriod;
     std::map<int, std::map<int, double> > budgetAmt;
     Model_Budget::instance().getBudgetEntry(m_date_selection, budgetPeriod, budgetAmt);
-    std::map<int, std::map<int, std::map<int, double> > > categoryStats;
+    Model_Category::Stats categoryStats;
     Model_Category::instance().getCategoryStats(categoryStats
         , nullptr
         , &date_range, Option::instance().getIgnoreFutureTransactions()
@@ -152,14 +152,14 @@ wxString mmReportBudgetingPerformance::getHTMLText()
 
     for (const auto& category : allCategories)
     {
-        for (const auto &i : categoryStats[category.CATEGID][-1])
+        for (const auto &i : categoryStats.row(category.CATEGID, -1))
         {
-            totals[category.CATEGID][-1] += categoryStats[category.CATEGID][-1][i.first];
+            totals[category.CATEGID][-1] += categoryStats(category.CATEGID, -1, i.first);
             for (const Model_Subcategory::Data& subcategory : allSubcategories)
             {
                 if (subcategory.CATEGID == category.CATEGID)
                     totals[category.CATEGID][subcategory.SUBCATEGID]
-                    += categoryStats[category.CATEGID][subcategory.SUBCATEGID][i.first];
+                    += categoryStats(category.CATEGID, subcategory.SUBCATEGID, i.first);
             }
         }
     }
@@ -212,10 +212,10 @@ wxString mmReportBudgetingPerformance::getHTMLText()
 
         monthlyEst += estimated;
         monthlyAct += actual;
-        for (const auto &i : categoryStats[category.CATEGID][-1])
+        for (const auto &i : categoryStats.row(category.CATEGID, -1))
             monthlyActual[i.first] += i.second;
 
-        DisplayRow(hb, estimated, actual, category.CATEGNAME, categoryStats[category.CATEGID][-1]);
+        DisplayRow(hb, estimated, actual, category.CATEGNAME, categoryStats.row(category.CATEGID, -1));
 
         for (const Model_Subcategory::Data& subcategory : allSubcategories)
         {
@@ -230,11 +230,11 @@ wxString mmReportBudgetingPerformance::getHTMLText()
 
             monthlyEst += estimated;
             monthlyAct += actual;
-            for (const auto &i : categoryStats[category.CATEGID][subcategory.SUBCATEGID])
+            for (const auto &i : categoryStats.row(category.CATEGID, subcategory.SUBCATEGID))
                 monthlyActual[i.first] += i.second;
 
             DisplayRow(hb, estimated, actual, category.CATEGNAME + ": "
-                + subcategory.SUBCATEGNAME, categoryStats[category.CATEGID][subcategory.SUBCATEGID]);
+                + subcategory.SUBCATEGNAME, categoryStats.row(category.CATEGID, subcategory.SUBCATEGID));
         }
     }
     hb.endTbody();
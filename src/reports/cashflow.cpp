@@ -179,6 +179,9 @@ void mmReportCashFlow::getStats(double& tInitialBalance, std::vector<ValueTrio>&
     } //end query
 
     const wxDateTime& dtBegin = today_;
+    // dtEnd only moves forward: carry the running balance instead of summing the history again
+    auto d_balance = daily_balance.begin();
+    double running_balance = 0.0;
     for (size_t idx = 0; idx < forecastVector.size(); idx++)
     {
         wxDateTime dtEnd = cashFlowReportType_ == MONTHLY
@@ -190,11 +193,9 @@ void mmReportCashFlow::getStats(double& tInitialBalance, std::vector<ValueTrio>&
                 forecastVector[idx].amount += balance.amount;
         }
 
-        for (const auto& d_balance : daily_balance)
-        {
-            if (!d_balance.first.IsLaterThan(dtEnd))
-                forecastVector[idx].amount += d_balance.second;
-        }
+        for (; d_balance != daily_balance.end() && !d_balance->first.IsLaterThan(dtEnd); ++d_balance)
+            running_balance += d_balance->second;
+        forecastVector[idx].amount += running_balance;
         forecastVector[idx].label = dtEnd.FormatISODate();
     }
 }
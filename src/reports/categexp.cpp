@@ -48,7 +48,7 @@ void  mmReportCategoryExpenses::RefreshData()
 {
     data_.clear();
     wxString color;
-    std::map<int, std::map<int, std::map<int, double> > > categoryStats;
+    Model_Category::Stats categoryStats;
     Model_Category::instance().getCategoryStats(categoryStats
         , accountArray_
         , const_cast<mmDateRange*>(m_date_range)
@@ -62,7 +62,7 @@ void  mmReportCategoryExpenses::RefreshData()
     for (const auto& category : Model_Category::instance().all(Model_Category::COL_CATEGNAME))
     {
         const wxString& sCategName = category.CATEGNAME;
-        double amt = categoryStats[category.CATEGID][-1][0];
+        double amt = categoryStats(category.CATEGID, -1, 0);
         if (type_ == COME && amt < 0.0) amt = 0;
         if (type_ == GOES && amt > 0.0) amt = 0;
         if (amt != 0.0)
@@ -73,7 +73,7 @@ void  mmReportCategoryExpenses::RefreshData()
         for (const auto& sub_category : subcategories)
         {
             wxString sFullCategName = Model_Category::full_name(category.CATEGID, sub_category.SUBCATEGID);
-            amt = categoryStats[category.CATEGID][sub_category.SUBCATEGID][0];
+            amt = categoryStats(category.CATEGID, sub_category.SUBCATEGID, 0);
             if (type_ == COME && amt < 0.0) amt = 0;
             if (type_ == GOES && amt > 0.0) amt = 0;
             if (amt != 0.0)
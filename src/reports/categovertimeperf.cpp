@@ -57,7 +57,7 @@ wxString mmReportCategoryOverTimePerformance::getHTMLText()
     m_date_range = new mmLast12Months();
 
     //Get statistic
-    std::map<int, std::map<int, std::map<int, double> > > categoryStats;
+    Model_Category::Stats categoryStats;
     Model_Category::instance().getCategoryStats(categoryStats
         , accountArray_
         , const_cast<mmDateRange*>(m_date_range)
@@ -76,7 +76,7 @@ wxString mmReportCategoryOverTimePerformance::getHTMLText()
         line.name = category.CATEGNAME;
         line.overall = 0;
         unsigned month = 0;
-        for (const auto &i : categoryStats[categID][-1])
+        for (const auto &i : categoryStats.row(categID, -1))
         {
             double value = i.second;
             line.period[month++] = value;
@@ -93,7 +93,7 @@ wxString mmReportCategoryOverTimePerformance::getHTMLText()
             line.name = category.CATEGNAME + " : " + sub_category.SUBCATEGNAME;
             line.overall = 0;
             month = 0;
-            for (const auto &i : categoryStats[categID][subcategID])
+            for (const auto &i : categoryStats.row(categID, subcategID))
             {
                 double value = i.second;
                 line.period[month++] = value;
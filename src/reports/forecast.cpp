@@ -39,22 +39,29 @@ int mmReportForecast::report_parameters()
 
 wxString mmReportForecast::getHTMLText()
 {
-    std::map<wxString, std::pair<double, double> > amount_by_day;
-    Model_Checking::Data_Set all_trans;
-
+    typedef DB_Projection<DB_Table_CHECKINGACCOUNT::TRANSDATE, DB_Table_CHECKINGACCOUNT::TRANSCODE
+        , DB_Table_CHECKINGACCOUNT::STATUS, DB_Table_CHECKINGACCOUNT::TRANSAMOUNT> Projection;
+    Projection::Row_Set transactions;
     if (m_date_range && m_date_range->is_with_date())
-        all_trans = Model_Checking::instance().find(DB_Table_CHECKINGACCOUNT::TRANSDATE(m_date_range->start_date().FormatISODate(), GREATER_OR_EQUAL)
-                    , DB_Table_CHECKINGACCOUNT::TRANSDATE(m_date_range->end_date().FormatISODate(), LESS_OR_EQUAL));
+        transactions = Model_Checking::instance().select<DB_Table_CHECKINGACCOUNT::TRANSDATE, DB_Table_CHECKINGACCOUNT::TRANSCODE
+            , DB_Table_CHECKINGACCOUNT::STATUS, DB_Table_CHECKINGACCOUNT::TRANSAMOUNT>(
+                DB_Table_CHECKINGACCOUNT::TRANSDATE(m_date_range->start_date().FormatISODate(), GREATER_OR_EQUAL)
+                , DB_Table_CHECKINGACCOUNT::TRANSDATE(m_date_range->end_date().FormatISODate(), LESS_OR_EQUAL));
     else
-        all_trans = Model_Checking::instance().all();
+        transactions = Model_Checking::instance().select<DB_Table_CHECKINGACCOUNT::TRANSDATE, DB_Table_CHECKINGACCOUNT::TRANSCODE
+            , DB_Table_CHECKINGACCOUNT::STATUS, DB_Table_CHECKINGACCOUNT::TRANSAMOUNT>();
 
-    for (const auto & trx : all_trans)
+    std::map<wxString, std::pair<double, double> > amount_by_day;
+    for (const auto& trx : transactions)
     {
-        if (Model_Checking::type(trx) == Model_Checking::TRANSFER)
+        const Model_Checking::TYPE type = Model_Checking::type(std::get<1>(trx));
+        if (type == Model_Checking::TRANSFER)
             continue;
 
-        amount_by_day[trx.TRANSDATE].first += Model_Checking::withdrawal(trx, -1);
-        amount_by_day[trx.TRANSDATE].second += Model_Checking::deposit(trx, -1);
+        double bal = Model_Checking::status(std::get<2>(trx)) == Model_Checking::VOID_
+            ? 0 : Model_Checking::amount(type, -1, std::get<3>(trx), 0);
+        amount_by_day[std::get<0>(trx)].first += bal <= 0 ? -bal : 0;
+        amount_by_day[std::get<0>(trx)].second += bal > 0 ? bal : 0;
     }
 
     loop_t contents;
@@ -25,7 +25,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "Model_Account.h"
 #include "Model_Checking.h"
-#include "Model_CurrencyHistory.h"
+#include "Model_CategoryCube.h"
+#include <set>
 
 
 mmReportIncomeExpenses::mmReportIncomeExpenses()
@@ -53,31 +54,27 @@ wxString mmReportIncomeExpenses::getHTMLText()
     hb.addHeader(3, getAccountNames());
     hb.addDateNow();
 
-    std::pair<double, double> income_expenses_pair;
-    for (const auto& transaction : Model_Checking::instance().find(
-        Model_Checking::TRANSDATE(m_date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(m_date_range->end_date(), LESS_OR_EQUAL)
-        , Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)))
+    std::pair<Money, Money> income_expenses;
+    std::set<int> accounts;
+    if (accountArray_)
     {
-        // Do not include asset or stock transfers in income expense calculations.
-        if (Model_Checking::foreignTransactionAsTransfer(transaction))
-            continue;
-
-        Model_Account::Data *account = Model_Account::instance().get(transaction.ACCOUNTID);
-        if (accountArray_)
-        {
-            if (!account || wxNOT_FOUND == accountArray_->Index(account->ACCOUNTNAME))
-                continue;
-        }
-        double convRate = 1;
-        // We got this far, get the currency conversion rate for this account
-        if (account) convRate = Model_CurrencyHistory::getDayRate(Model_Account::currency(account)->CURRENCYID,transaction.TRANSDATE);
-
-        if (Model_Checking::type(transaction) == Model_Checking::DEPOSIT)
-            income_expenses_pair.first += transaction.TRANSAMOUNT * convRate;
-        else if (Model_Checking::type(transaction) == Model_Checking::WITHDRAWAL)
-            income_expenses_pair.second += transaction.TRANSAMOUNT * convRate;
+        for (const auto& id : Model_Account::account_ids(*accountArray_))
+            accounts.insert(id);
     }
+    Model_CategoryCube& cube = Model_CategoryCube::instance();
+    cube.for_each(DB_Date(m_date_range->start_date()), DB_Date(m_date_range->end_date())
+        , [&](const Model_CategoryCube::Key& k, const Money& amount)
+    {
+        if (accountArray_ && accounts.find(k.account) == accounts.end()) return;
+
+        // Do not include asset or stock transfers in income expense calculations.
+        if (k.type == Model_CategoryCube::DEPOSIT)
+            income_expenses.first += amount;
+        else if (k.type == Model_CategoryCube::WITHDRAWAL)
+            income_expenses.second += amount;
+    });
+    const std::pair<double, double> income_expenses_pair(income_expenses.first.to_double(cube.precision())
+        , income_expenses.second.to_double(cube.precision()));
 
     BarGraphData vt;
     std::vector<BarGraphData> valueList;
@@ -158,31 +155,26 @@ wxString mmReportIncomeExpensesMonthly::getHTMLText()
 {
     wxString headerMsg = getAccountNames();
 
-    std::map<int, std::pair<double, double> > incomeExpensesStats;
+    std::map<int, std::pair<Money, Money> > incomeExpensesStats;
     //TODO: init all the map values with 0.0
-    for (const auto& transaction : Model_Checking::instance().find(
-        Model_Checking::TRANSDATE(m_date_range->start_date(), GREATER_OR_EQUAL)
-        , Model_Checking::TRANSDATE(m_date_range->end_date(), LESS_OR_EQUAL)
-        , Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)))
+    std::set<int> accounts;
+    if (accountArray_)
     {
-        Model_Account::Data *account = Model_Account::instance().get(transaction.ACCOUNTID);
-        if (accountArray_)
-        {
-            if (!account || wxNOT_FOUND == accountArray_->Index(account->ACCOUNTNAME))
-                continue;
-        }
-        double convRate = 1;
-        // We got this far, get the currency conversion rate for this account
-        if (account) convRate = Model_CurrencyHistory::getDayRate(Model_Account::currency(account)->CURRENCYID, transaction.TRANSDATE);
-
-        int idx = (Model_Checking::TRANSDATE(transaction).GetYear() * 100
-            + Model_Checking::TRANSDATE(transaction).GetMonth());
-
-        if (Model_Checking::type(transaction) == Model_Checking::DEPOSIT)
-            incomeExpensesStats[idx].first += transaction.TRANSAMOUNT * convRate;
-        else if (Model_Checking::type(transaction) == Model_Checking::WITHDRAWAL)
-            incomeExpensesStats[idx].second += transaction.TRANSAMOUNT * convRate;
+        for (const auto& id : Model_Account::account_ids(*accountArray_))
+            accounts.insert(id);
     }
+    Model_CategoryCube& cube = Model_CategoryCube::instance();
+    cube.for_each(DB_Date(m_date_range->start_date()), DB_Date(m_date_range->end_date())
+        , [&](const Model_CategoryCube::Key& k, const Money& amount)
+    {
+        if (accountArray_ && accounts.find(k.account) == accounts.end()) return;
+
+        int idx = k.month - 1;
+        if (k.type == Model_CategoryCube::DEPOSIT || k.type == Model_CategoryCube::DEPOSIT_AS_TRANSFER)
+            incomeExpensesStats[idx].first += amount;
+        else if (k.type == Model_CategoryCube::WITHDRAWAL || k.type == Model_CategoryCube::WITHDRAWAL_AS_TRANSFER)
+            incomeExpensesStats[idx].second += amount;
+    });
 
     mmHTMLBuilder hb;
     hb.init();
@@ -211,8 +203,9 @@ wxString mmReportIncomeExpensesMonthly::getHTMLText()
         hb.endThead();
         wxLogDebug("from %s till %s", m_date_range->start_date().FormatISODate(), m_date_range->end_date().FormatISODate());
 
-        double total_expenses = 0.0;
-        double total_income = 0.0;
+        const int precision = cube.precision();
+        Money total_expenses;
+        Money total_income;
         hb.startTbody();
         for (const auto &stats : incomeExpensesStats)
         {
@@ -222,17 +215,17 @@ wxString mmReportIncomeExpensesMonthly::getHTMLText()
             hb.startTableRow();
             hb.addTableCell(wxString() << stats.first / 100);
             hb.addTableCellMonth(static_cast<wxDateTime::Month>(stats.first % 100));
-            hb.addMoneyCell(stats.second.first);
-            hb.addMoneyCell(stats.second.second);
-            hb.addMoneyCell(stats.second.first - stats.second.second);
+            hb.addMoneyCell(stats.second.first.to_double(precision));
+            hb.addMoneyCell(stats.second.second.to_double(precision));
+            hb.addMoneyCell((stats.second.first - stats.second.second).to_double(precision));
             hb.endTableRow();
         }
         hb.endTbody();
 
         std::vector<double> data;
-        data.push_back(total_income);
-        data.push_back(total_expenses);
-        data.push_back(total_income - total_expenses);
+        data.push_back(total_income.to_double(precision));
+        data.push_back(total_expenses.to_double(precision));
+        data.push_back((total_income - total_expenses).to_double(precision));
 
         hb.addTotalRow(_("Total:"), 5, data);
 
@@ -164,7 +164,7 @@ void mmReportPayeeExpenses::getPayeeStats(std::map<int, std::pair<double, double
         Model_Checking::STATUS(Model_Checking::VOID_, NOT_EQUAL)
         , Model_Checking::TRANSDATE(date_range->start_date(), GREATER_OR_EQUAL)
         , Model_Checking::TRANSDATE(date_range->end_date(), LESS_OR_EQUAL));
-    const auto all_splits = Model_Splittransaction::instance().get_all();
+    const auto& all_splits = Model_Splittransaction::instance().get_all();
     for (const auto& trx: transactions)
     {
         if (Model_Checking::type(trx) == Model_Checking::TRANSFER) continue;
@@ -173,10 +173,9 @@ void mmReportPayeeExpenses::getPayeeStats(std::map<int, std::pair<double, double
         if (Model_Checking::foreignTransactionAsTransfer(trx))
             continue;
 
-        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(trx.ACCOUNTID)->CURRENCYID, trx.TRANSDATE);
+        const double convRate = Model_CurrencyHistory::getDayRate(Model_Account::instance().get(trx.ACCOUNTID)->CURRENCYID, trx.TRANSDATE_YMD);
 
-        Model_Splittransaction::Data_Set splits;
-        if (all_splits.count(trx.id())) splits = all_splits.at(trx.id());
+        const auto splits = all_splits[trx.id()];
         if (splits.empty())
         {
             if (Model_Checking::type(trx) == Model_Checking::DEPOSIT)
@@ -301,11 +301,13 @@ mm_html_template::mm_html_template(const wxString& arg_template): html_template(
 
 void mm_html_template::load_context()
 {
+    // the values below are read from the table, write the pending ones first
+    Model_Infotable::instance().Flush();
     (*this)(L"TODAY") = mmGetDateForDisplay(wxDate::Today().FormatISODate())
         + " " + wxDate::Now().FormatISOTime();
+    (*this)(L"INFOTABLE") = Model_Infotable::to_loop_t();
     for (const auto &r: Model_Infotable::instance().all())
         (*this)(r.INFONAME.ToStdWstring()) = r.INFOVALUE;
-    (*this)(L"INFOTABLE") = Model_Infotable::to_loop_t();
 
     const Model_Currency::Data* currency = Model_Currency::GetBaseCurrency();
     if (currency) currency->to_template(*this);
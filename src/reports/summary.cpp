@@ -23,103 +23,8 @@
 #include "Model_Account.h"
 #include "Model_CurrencyHistory.h"
 #include "Model_Stock.h"
-#include "Model_StockHistory.h"
 #include <algorithm>
 
-class mmHistoryItem
-{
-public:
-    mmHistoryItem();
-
-    int         acctId;
-    int         stockId;
-    wxDate      purchaseDate;
-    wxString    purchaseDateStr;
-    double      purchasePrice;
-    double      numShares;
-    Model_StockHistory::Data_Set stockHist;
-};
-
-mmHistoryItem::mmHistoryItem()
-{
-    acctId = stockId = 0;
-    purchasePrice = numShares = 0.0;
-}
-
-class mmHistoryData : public std::vector<mmHistoryItem>
-{
-public:
-    double getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date);
-};
-
-double mmHistoryData::getDailyBalanceAt(const Model_Account::Data *account, const wxDate& date)
-{
-    const wxString& strDate = date.FormatISODate();
-    std::map<int, double> totBalance;
-
-    for (const auto & stock : *this)
-    {
-        if (stock.acctId != account->id()) {
-            continue;
-        }
-
-        wxString precValueDate, nextValueDate;
-
-        double valueAtDate = 0.0, precValue = 0.0, nextValue = 0.0;
-
-        for (const auto & hist : stock.stockHist)
-        {
-            // test for the date requested
-            if (hist.DATE == strDate)
-            {
-                valueAtDate = hist.VALUE;
-                break;
-            }
-            // if not found, search for previous and next date
-            if (precValue == 0.0 && hist.DATE < strDate)
-            {
-                precValue = hist.VALUE;
-                precValueDate = hist.DATE;
-            }
-            if (hist.DATE > strDate)
-            {
-                nextValue = hist.VALUE;
-                nextValueDate = hist.DATE;
-            }
-            // end conditions: prec value assigned and price date < requested date
-            if (precValue != 0.0 && hist.DATE < strDate) {
-                break;
-            }
-        }
-        if (valueAtDate == 0.0)
-        {
-            //  if previous not found but if the given date is after purchase date, takes purchase price
-            if (precValue == 0.0 && date >= stock.purchaseDate)
-            {
-                precValue = stock.purchasePrice;
-                precValueDate = stock.purchaseDateStr;
-            }
-            //  if next not found and the accoung is open, takes previous date
-            if (nextValue == 0.0 && Model_Account::status(account) == Model_Account::OPEN)
-            {
-                nextValue = precValue;
-                nextValueDate = precValueDate;
-            }
-            if (precValue > 0.0 && nextValue > 0.0 && precValueDate >= stock.purchaseDateStr && nextValueDate >= stock.purchaseDateStr) {
-                valueAtDate = precValue;
-            }
-        }
-
-        totBalance[stock.stockId] += stock.numShares * valueAtDate;
-    }
-
-    double balance = 0.0;
-    for (const auto& it : totBalance)
-        balance += it.second;
-
-    return balance;
-}
-
 mmReportSummaryByDate::mmReportSummaryByDate(int mode)
 : mmPrintableBase("mmReportSummaryByDate")
 , mode_(mode)
@@ -133,8 +38,6 @@ wxString mmReportSummaryByDate::getHTMLText()
     wxString        datePrec;
     wxDate          date, dateStart = wxDate::Today(), dateEnd = wxDate::Today();
     wxDateSpan      span;
-    mmHistoryItem   *pHistItem;
-    mmHistoryData   arHistory;
     std::vector<balanceMap> balanceMapVec(Model_Account::instance().all().size());
     std::vector<std::map<wxDate, double>::const_iterator> arIt(balanceMapVec.size());
     std::vector<double> arBalance(balanceMapVec.size());
@@ -172,12 +75,15 @@ wxString mmReportSummaryByDate::getHTMLText()
         {
             //  in balanceMapVec ci sono i totali dei movimenti giorno per giorno
             const Model_Currency::Data* currency = Model_Account::currency(account);
-            for (const auto& tran : Model_Account::transaction(account))
-            {
-                balanceMapVec[i][Model_Checking::TRANSDATE(tran)]
-                    += Model_Checking::balance(tran, account.ACCOUNTID)
-                    * Model_CurrencyHistory::getDayRate(currency->id(), tran.TRANSDATE);
-            }
+            const auto transactions = Model_Account::transaction(account);
+            std::vector<std::pair<DB_Date, double> > amounts;
+            amounts.reserve(transactions.size());
+            for (const auto& tran : transactions)
+                amounts.push_back(std::make_pair(tran.TRANSDATE_YMD, Model_Checking::balance(tran, account.ACCOUNTID)));
+            Model_CurrencyHistory::applyDayRate(currency->id(), amounts); // sorted by date, one pass
+
+            for (size_t t = 0; t < transactions.size(); t++)
+                balanceMapVec[i][Model_Checking::TRANSDATE(transactions[t])] += amounts[t].second;
             if (Model_Account::type(account) != Model_Account::TERM && balanceMapVec[i].size())
             {
                 date = balanceMapVec[i].begin()->first;
@@ -187,24 +93,6 @@ wxString mmReportSummaryByDate::getHTMLText()
             }
             arBalance[i] = account.INITIALBAL * Model_CurrencyHistory::getDayRate(currency->id(), dateStart);
         }
-        else
-        {
-            Model_Stock::Data_Set stocks = Model_Stock::instance().find(Model_Stock::HELDAT(account.id()));
-            for (const auto & stock : stocks)
-            {
-                arHistory.resize(arHistory.size() + 1);
-                pHistItem = arHistory.data() + arHistory.size() - 1;
-                pHistItem->acctId = account.id();
-                pHistItem->stockId = stock.STOCKID;
-                pHistItem->purchasePrice = stock.PURCHASEPRICE;
-                pHistItem->purchaseDate = Model_Stock::PURCHASEDATE(stock);
-                pHistItem->purchaseDateStr = stock.PURCHASEDATE;
-                pHistItem->numShares = stock.NUMSHARES;
-                pHistItem->stockHist = Model_StockHistory::instance().find(Model_StockHistory::SYMBOL(stock.SYMBOL));
-                std::stable_sort(pHistItem->stockHist.begin(), pHistItem->stockHist.end(), SorterByDATE());
-                std::reverse(pHistItem->stockHist.begin(), pHistItem->stockHist.end());
-            }
-        }
         i++;
     }
 
@@ -251,9 +139,17 @@ wxString mmReportSummaryByDate::getHTMLText()
         arDates.push_back(date);
     }
 
+    //  value the portfolios over the whole date grid at once
+    std::map<int, std::vector<double> > stockBalances;
+    for (const auto& account : Model_Account::instance().all())
+    {
+        if (Model_Account::type(account) == Model_Account::INVESTMENT)
+            stockBalances[account.ACCOUNTID] = Model_Stock::instance().getDailyBalanceAt(&account, arDates);
+    }
 
-    for (const auto & dd : arDates)
+    for (size_t n = 0; n < arDates.size(); n++)
     {
+        const wxDate& dd = arDates[n];
         int k = 0;
         double total = 0.0;
         for (auto& account: Model_Account::instance().all())
@@ -275,7 +171,7 @@ wxString mmReportSummaryByDate::getHTMLText()
                 if (currency) {
                     convRate = Model_CurrencyHistory::getDayRate(currency->id(), dd);
                 }
-                arBalance[k] = arHistory.getDailyBalanceAt(&account, dd) * convRate;
+                arBalance[k] = stockBalances[account.ACCOUNTID][n] * convRate;
             }
             k++;
         }
@@ -137,7 +137,7 @@ wxString mmReportTransactions::getHTMLText()
         if (acc)
         {
             const double amount = Model_Checking::balance(transaction, acc->ACCOUNTID);
-            const double convRate = Model_CurrencyHistory::getDayRate(curr->CURRENCYID, transaction.TRANSDATE);
+            const double convRate = Model_CurrencyHistory::getDayRate(curr->CURRENCYID, transaction.TRANSDATE_YMD);
             hb.addCurrencyCell(amount, curr);
             total[curr->CURRENCYID] += amount;
             total_in_base_curr[curr->CURRENCYID] += amount * convRate;
@@ -180,15 +180,15 @@ wxString mmReportTransactions::getHTMLText()
 
 void mmReportTransactions::Run(mmFilterTransactionsDialog* dlg)
 {
-    const auto splits = Model_Splittransaction::instance().get_all();
+    const auto& splits = Model_Splittransaction::instance().get_all();
     auto categ = m_transDialog->getCategId();
     auto subcateg = m_transDialog->getSubCategId();
     bool similar = !m_transDialog->getSimilarStatus();
     bool category = dlg->getCategoryCheckBox();
     for (const auto& tran : Model_Checking::instance().all()) //TODO: find should be faster
     {
+        if (!dlg->checkAll(tran, Model_Checking::Row(m_refAccountID, tran.TRANSID))) continue;
         Model_Checking::Full_Data full_tran(m_refAccountID, tran, splits);
-        if (!dlg->checkAll(full_tran, m_refAccountID)) continue;
         full_tran.PAYEENAME = full_tran.real_payee_name(m_refAccountID);
         full_tran.TRANSAMOUNT = tran.TRANSAMOUNT;
 
@@ -265,7 +265,7 @@ void transactionsUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
             return mmErrorDialogs::InvalidCategory(m_categ_btn);
     }
 
-    const auto split = Model_Splittransaction::instance().get_all();
+    const auto& split = Model_Splittransaction::instance().get_all();
 
     Model_Checking::instance().Savepoint();
 
@@ -295,11 +295,11 @@ void transactionsUpdateDialog::OnOk(wxCommandEvent& WXUNUSED(event))
                 trx->NOTES = m_notes_ctrl->GetValue();
         }
 
-        if (m_amount_checkbox->IsChecked() && (split.find(trx->TRANSID) == split.end()))
+        if (m_amount_checkbox->IsChecked() && split[trx->TRANSID].empty())
         {
             trx->TRANSAMOUNT = amount;
         }
-        if (m_categ_checkbox->IsChecked() && (split.find(trx->TRANSID) == split.end()))
+        if (m_categ_checkbox->IsChecked() && split[trx->TRANSID].empty())
         {
             trx->CATEGID = m_categ_id;
             trx->SUBCATEGID = m_subcateg_id;
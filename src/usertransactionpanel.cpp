@@ -71,11 +71,13 @@ UserTransactionPanel::UserTransactionPanel(wxWindow *parent
     wxDateTime start = wxDateTime::UNow();
     Create();
     DataToControls();
+    Model_Checking::instance().pin(m_transaction_id);
     Model_Usage::instance().pageview(this, (wxDateTime::UNow() - start).GetMilliseconds().ToLong());
 }
 
 UserTransactionPanel::~UserTransactionPanel()
 {
+    Model_Checking::instance().unpin(m_transaction_id);
 }
 
 void UserTransactionPanel::Create()
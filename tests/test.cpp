@@ -0,0 +1,167 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "option.h"
+#include "Model_Account.h"
+#include "Model_Asset.h"
+#include "Model_Attachment.h"
+#include "Model_Billsdeposits.h"
+#include "Model_Budget.h"
+#include "Model_Budgetsplittransaction.h"
+#include "Model_Budgetyear.h"
+#include "Model_Category.h"
+#include "Model_CategoryCube.h"
+#include "Model_CheckingColumns.h"
+#include "Model_Currency.h"
+#include "Model_CurrencyHistory.h"
+#include "Model_CustomField.h"
+#include "Model_CustomFieldData.h"
+#include "Model_Infotable.h"
+#include "Model_Ledger.h"
+#include "Model_Payee.h"
+#include "Model_Report.h"
+#include "Model_Setting.h"
+#include "Model_Shareinfo.h"
+#include "Model_Splittransaction.h"
+#include "Model_Stock.h"
+#include "Model_StockHistory.h"
+#include "Model_Subcategory.h"
+#include "Model_Translink.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct Test
+    {
+        const char* name;
+        mmTest::Function function;
+    };
+
+    std::vector<Test>& tests()
+    {
+        static std::vector<Test> registered;
+        return registered;
+    }
+
+    int failures = 0;
+}
+
+mmTest::mmTest(const char* name, Function function)
+{
+    tests().push_back(Test{ name, function });
+}
+
+void mmTest::check(bool condition, const char* expression, const char* file, int line)
+{
+    if (condition) return;
+    ++failures;
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+}
+
+int mmTest::run(int argc, char* argv[])
+{
+    int run = 0, failed = 0;
+    for (const auto& test : tests())
+    {
+        if (argc > 1 && !strstr(test.name, argv[1])) continue;
+
+        const int before = failures;
+        test.function();
+        ++run;
+        if (failures != before) ++failed;
+        printf("%s %s\n", failures == before ? "ok  " : "FAIL", test.name);
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+mmTestDatabase::mmTestDatabase()
+{
+    db_.Open(":memory:");
+
+    Model_Setting::instance(&db_);
+    Model_Infotable::instance(&db_);
+    Model_Asset::instance(&db_);
+    Model_Stock::instance(&db_);
+    Model_StockHistory::instance(&db_);
+    Model_Account::instance(&db_);
+    Model_Payee::instance(&db_);
+    Model_Checking::instance(&db_);
+    Model_Currency::instance(&db_);
+    Model_CurrencyHistory::instance(&db_);
+    Model_Budgetyear::instance(&db_);
+    Model_Subcategory::instance(&db_); // subcategory must be initialized before category
+    Model_Category::instance(&db_);
+    Model_Billsdeposits::instance(&db_);
+    Model_Splittransaction::instance(&db_);
+    Model_Budgetsplittransaction::instance(&db_);
+    Model_Budget::instance(&db_);
+    Model_Report::instance(&db_);
+    Model_Attachment::instance(&db_);
+    Model_CustomFieldData::instance(&db_);
+    Model_CustomField::instance(&db_);
+    Model_Translink::instance(&db_);
+    Model_Shareinfo::instance(&db_);
+
+    Model_Ledger::instance().reset();
+    Model_CheckingColumns::instance().reset();
+    Model_CategoryCube::instance().reset();
+
+    Option::instance().setBaseCurrencyID(Model_Currency::instance().GetCurrencyRecord("USD")->CURRENCYID);
+}
+
+mmTestDatabase::~mmTestDatabase()
+{
+    DB_Statement_Cache::instance().reset(&db_);
+    db_.Close();
+}
+
+int mmTestDatabase::account(const wxString& name, const wxString& currency_symbol)
+{
+    Model_Account::Data* account = Model_Account::instance().create();
+    account->ACCOUNTNAME = name;
+    account->ACCOUNTTYPE = Model_Account::all_type()[Model_Account::CHECKING];
+    account->STATUS = Model_Account::all_status()[Model_Account::OPEN];
+    account->FAVORITEACCT = "TRUE";
+    account->CURRENCYID = Model_Currency::instance().GetCurrencyRecord(currency_symbol)->CURRENCYID;
+    account->INITIALBAL = 0;
+    return Model_Account::instance().save(account);
+}
+
+Model_Checking::Data* mmTestDatabase::transaction(const wxString& date, int account_id, Model_Checking::TYPE type, double amount
+    , int to_account_id, double to_amount)
+{
+    Model_Checking::Data* r = Model_Checking::instance().create();
+    r->TRANSDATE = date;
+    r->ACCOUNTID = account_id;
+    r->TOACCOUNTID = to_account_id;
+    r->PAYEEID = -1;
+    r->TRANSCODE = Model_Checking::all_type()[type];
+    r->TRANSAMOUNT = amount;
+    r->TOTRANSAMOUNT = (type == Model_Checking::TRANSFER) ? to_amount : amount;
+    r->CATEGID = -1;
+    r->SUBCATEGID = -1;
+    Model_Checking::instance().save(r);
+    return r;
+}
+
+int main(int argc, char* argv[])
+{
+    return mmTest::run(argc, argv);
+}
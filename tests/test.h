@@ -0,0 +1,63 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#pragma once
+
+#include "Model_Checking.h"
+#include <wx/wxsqlite3.h>
+
+/**
+* The model tests: MMEX_TEST(name) { ... } defines and registers a test, CHECK(condition)
+* reports a failed condition and lets the test go on. Run them all with ctest, or the
+* tests whose name contains a word with: mmex_tests word
+*/
+class mmTest
+{
+public:
+    typedef void (*Function)();
+
+    mmTest(const char* name, Function function);
+
+    static void check(bool condition, const char* expression, const char* file, int line);
+    static int run(int argc, char* argv[]);
+};
+
+#define MMEX_TEST(name) \
+    static void name(); \
+    static const mmTest name##_test(#name, name); \
+    static void name()
+
+#define CHECK(condition) mmTest::check((condition), #condition, __FILE__, __LINE__)
+
+/**
+* A new database in memory with every model pointed to it, as InitializeModelTables()
+* does for a database file, for the duration of a test. The base currency is USD.
+*/
+class mmTestDatabase
+{
+public:
+    mmTestDatabase();
+    ~mmTestDatabase();
+
+    /** Add an account in the currency of the symbol, return its ACCOUNTID */
+    int account(const wxString& name, const wxString& currency_symbol = "USD");
+    /** Add a transaction dated "YYYY-MM-DD", a transfer to to_account_id of to_amount for a TRANSFER */
+    Model_Checking::Data* transaction(const wxString& date, int account_id, Model_Checking::TYPE type, double amount
+        , int to_account_id = -1, double to_amount = 0);
+
+private:
+    wxSQLite3Database db_;
+};
@@ -0,0 +1,153 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_Attachment.h"
+
+/*
+* Each test counts the attachments, changes them one way, then checks the count of every
+* object against the number of attachments read from the database.
+*/
+namespace
+{
+    const int REFS = 4;
+
+    /** The number of attachments of the objects 1 .. REFS of every reference type */
+    std::vector<int> counted()
+    {
+        std::vector<int> counts;
+        for (const auto& choice : Model_Attachment::REFTYPE_CHOICES)
+        {
+            for (int ref_id = 1; ref_id <= REFS; ++ref_id)
+                counts.push_back(Model_Attachment::instance().count(choice.first, ref_id));
+        }
+        return counts;
+    }
+
+    std::vector<int> stored()
+    {
+        std::vector<int> counts;
+        for (const auto& choice : Model_Attachment::REFTYPE_CHOICES)
+        {
+            for (int ref_id = 1; ref_id <= REFS; ++ref_id)
+                counts.push_back(static_cast<int>(Model_Attachment::instance()
+                    .find(Model_Attachment::DB_Table_ATTACHMENT::REFTYPE(choice.second), Model_Attachment::REFID(ref_id)).size()));
+        }
+        return counts;
+    }
+
+    void check_stored()
+    {
+        CHECK(counted() == stored());
+    }
+
+    Model_Attachment::Data* attachment(Model_Attachment::REFTYPE reftype, int ref_id)
+    {
+        Model_Attachment::Data* r = Model_Attachment::instance().create();
+        r->REFTYPE = Model_Attachment::reftype_desc(reftype);
+        r->REFID = ref_id;
+        r->DESCRIPTION = "";
+        r->FILENAME = wxString::Format("%s_%d.pdf", r->REFTYPE, ref_id);
+        Model_Attachment::instance().save(r);
+        return r;
+    }
+}
+
+MMEX_TEST(attachment_save_insert)
+{
+    mmTestDatabase db;
+    attachment(Model_Attachment::TRANSACTION, 1);
+    counted();
+
+    attachment(Model_Attachment::TRANSACTION, 1);
+    attachment(Model_Attachment::TRANSACTION, 3);
+    attachment(Model_Attachment::PAYEE, 3);
+    CHECK(Model_Attachment::instance().count(Model_Attachment::TRANSACTION, 1) == 2);
+    check_stored();
+}
+
+MMEX_TEST(attachment_save_update)
+{
+    mmTestDatabase db;
+    Model_Attachment::Data* r = attachment(Model_Attachment::TRANSACTION, 1);
+    attachment(Model_Attachment::TRANSACTION, 2);
+    counted();
+
+    r->REFID = 2; // to another object
+    Model_Attachment::instance().save(r);
+    CHECK(Model_Attachment::instance().count(Model_Attachment::TRANSACTION, 2) == 2);
+    check_stored();
+
+    r->REFTYPE = Model_Attachment::reftype_desc(Model_Attachment::STOCK); // to another reference type
+    Model_Attachment::instance().save(r);
+    check_stored();
+}
+
+MMEX_TEST(attachment_remove)
+{
+    mmTestDatabase db;
+    const int a = attachment(Model_Attachment::TRANSACTION, 1)->ATTACHMENTID;
+    const int b = attachment(Model_Attachment::ASSET, 1)->ATTACHMENTID;
+    attachment(Model_Attachment::TRANSACTION, 1);
+    counted();
+
+    Model_Attachment::instance().remove(a);
+    check_stored();
+    Model_Attachment::instance().remove(b);
+    CHECK(Model_Attachment::instance().count(Model_Attachment::ASSET, 1) == 0);
+    check_stored();
+}
+
+MMEX_TEST(attachment_update_where)
+{
+    mmTestDatabase db;
+    attachment(Model_Attachment::TRANSACTION, 1);
+    attachment(Model_Attachment::TRANSACTION, 2);
+    attachment(Model_Attachment::PAYEE, 1);
+    counted();
+
+    Model_Attachment::instance().update_where(SET<Model_Attachment::REFID>(4)
+        , Model_Attachment::DB_Table_ATTACHMENT::REFTYPE(Model_Attachment::reftype_desc(Model_Attachment::TRANSACTION)));
+    CHECK(Model_Attachment::instance().count(Model_Attachment::TRANSACTION, 4) == 2);
+    check_stored();
+}
+
+MMEX_TEST(attachment_batch_save)
+{
+    mmTestDatabase db;
+    attachment(Model_Attachment::TRANSACTION, 1);
+    attachment(Model_Attachment::TRANSACTION, 2);
+    counted();
+
+    Model_Attachment::Data_Set rows = Model_Attachment::instance().all();
+    for (auto& r : rows) r.REFID = 3;
+    Model_Attachment::Data added;
+    added.REFTYPE = Model_Attachment::reftype_desc(Model_Attachment::BANKACCOUNT);
+    added.REFID = 1;
+    added.DESCRIPTION = "";
+    added.FILENAME = "added.pdf";
+    rows.push_back(added);
+    Model_Attachment::instance().save(rows);
+    CHECK(Model_Attachment::instance().count(Model_Attachment::TRANSACTION, 3) == 2);
+    check_stored();
+
+    // a batch of a single row changes the revision once, like save() of a record
+    Model_Attachment::Data_Set row;
+    row.push_back(rows[0]);
+    row[0].REFID = 1;
+    Model_Attachment::instance().save(row);
+    check_stored();
+}
@@ -0,0 +1,203 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_CategoryCube.h"
+#include "Model_Splittransaction.h"
+
+/*
+* Each test builds the cube, changes the transactions or their splits one way, then checks
+* the amounts the cube visits, over whole and partial months, against those of a rebuilt cube.
+*/
+namespace
+{
+    typedef std::map<std::tuple<int, int, int, int, int, int>, long long> Amounts;
+
+    /** The amounts visited between the dates, in minor units summed by key */
+    Amounts visited(const wxString& from, const wxString& to)
+    {
+        Amounts amounts;
+        Model_CategoryCube::instance().for_each(DB_Date(from), DB_Date(to)
+            , [&amounts](const Model_CategoryCube::Key& k, const Money& amount)
+            {
+                amounts[std::make_tuple(k.month, k.account, k.categ, k.subcateg, k.type, k.split)] += amount.units();
+            });
+        for (auto it = amounts.begin(); it != amounts.end(); )
+            it = (it->second == 0) ? amounts.erase(it) : ++it;
+        return amounts;
+    }
+
+    std::vector<Amounts> snapshot()
+    {
+        std::vector<Amounts> amounts;
+        amounts.push_back(visited("2019-12-01", "2020-02-29")); // whole months
+        amounts.push_back(visited("2020-01-03", "2020-02-10")); // partial months
+        amounts.push_back(visited("2020-01-05", "2020-01-20")); // within a month
+        return amounts;
+    }
+
+    void check_rebuilt()
+    {
+        const std::vector<Amounts> patched = snapshot();
+        Model_CategoryCube::instance().reset();
+        CHECK(patched == snapshot());
+    }
+
+    Model_Splittransaction::Data* split(int trans_id, int categ_id, double amount)
+    {
+        Model_Splittransaction::Data* r = Model_Splittransaction::instance().create();
+        r->TRANSID = trans_id;
+        r->CATEGID = categ_id;
+        r->SUBCATEGID = -1;
+        r->SPLITTRANSAMOUNT = amount;
+        Model_Splittransaction::instance().save(r);
+        return r;
+    }
+}
+
+MMEX_TEST(cube_save_insert)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), e = db.account("E", "EUR");
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    snapshot();
+
+    db.transaction("2019-12-31", a, Model_Checking::WITHDRAWAL, 10);
+    db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 20);
+    db.transaction("2020-02-05", a, Model_Checking::TRANSFER, 30, e, 25);
+    db.transaction("2020-02-06", e, Model_Checking::DEPOSIT, 40);
+    check_rebuilt();
+}
+
+MMEX_TEST(cube_save_update)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    Model_Checking::Data* r = db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 20);
+    db.transaction("2020-01-12", a, Model_Checking::DEPOSIT, 50);
+    snapshot();
+
+    r->CATEGID = 3;
+    r->TRANSAMOUNT = 25;
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+
+    r->TRANSDATE = "2020-02-01"; // to another month
+    r->ACCOUNTID = b;
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+
+    r->TRANSCODE = Model_Checking::all_type()[Model_Checking::DEPOSIT];
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+
+    r->STATUS = Model_Checking::toShortStatus(Model_Checking::all_status()[Model_Checking::VOID_]);
+    Model_Checking::instance().save(r);
+    CHECK(visited("2020-02-01", "2020-02-01").empty());
+    check_rebuilt();
+}
+
+MMEX_TEST(cube_remove)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 20)->TRANSID;
+    const int t2 = db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    split(t2, 1, 10);
+    split(t2, 2, 20);
+    snapshot();
+
+    Model_Checking::instance().remove(t1);
+    check_rebuilt();
+    Model_Checking::instance().remove(t2);
+    CHECK(visited("2020-01-01", "2020-01-31").empty());
+    check_rebuilt();
+}
+
+MMEX_TEST(cube_splits)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-02-10", a, Model_Checking::TRANSFER, 30, db.account("B"), 30)->TRANSID;
+    snapshot();
+
+    Model_Splittransaction::Data* s = split(t1, 1, 10); // the transaction becomes split
+    const int other = split(t1, 2, 20)->SPLITTRANSID;
+    split(t2, 1, 30);
+    check_rebuilt();
+
+    s->SPLITTRANSAMOUNT = 15;
+    s->TRANSID = t2; // to another transaction
+    Model_Splittransaction::instance().save(s);
+    check_rebuilt();
+
+    Model_Splittransaction::instance().remove(other); // t1 is whole again
+    check_rebuilt();
+
+    Model_Splittransaction::Data_Set rows;
+    for (int categ_id = 3; categ_id <= 4; ++categ_id)
+    {
+        Model_Splittransaction::Data r;
+        r.CATEGID = categ_id;
+        r.SUBCATEGID = -1;
+        r.SPLITTRANSAMOUNT = 15;
+        rows.push_back(r);
+    }
+    Model_Splittransaction::instance().update(rows, t1);
+    check_rebuilt();
+}
+
+MMEX_TEST(cube_update_where)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 20);
+    db.transaction("2020-01-31", a, Model_Checking::DEPOSIT, 50);
+    db.transaction("2020-02-01", b, Model_Checking::DEPOSIT, 70);
+    snapshot();
+
+    Model_Checking::instance().update_where(SET<Model_Checking::CATEGID>(5), Model_Checking::ACCOUNTID(a));
+    check_rebuilt();
+
+    Model_Checking::instance().update_where(SET<Model_Checking::ACCOUNTID>(b), Model_Checking::ACCOUNTID(a));
+    check_rebuilt();
+}
+
+MMEX_TEST(cube_batch_save)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    Model_Checking::Data* first = db.transaction("2020-01-10", a, Model_Checking::WITHDRAWAL, 20);
+    Model_Checking::Data* second = db.transaction("2020-01-31", a, Model_Checking::DEPOSIT, 50);
+    snapshot();
+
+    first->TRANSDATE = "2020-02-02";
+    second->TRANSAMOUNT = 60;
+    Model_Checking::Data* added = Model_Checking::instance().create();
+    *added = *second;
+    added->TRANSID = -1;
+    added->TRANSDATE = "2019-12-15";
+    std::vector<Model_Checking::Data*> rows = { first, second, added };
+    Model_Checking::instance().save(rows);
+    check_rebuilt();
+
+    // a batch of a single row changes the revision once, like save() of a record
+    std::vector<Model_Checking::Data*> row = { first };
+    first->TRANSAMOUNT = 5;
+    Model_Checking::instance().save(row);
+    check_rebuilt();
+}
@@ -0,0 +1,177 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_CheckingColumns.h"
+
+/*
+* Each test builds the columns, changes the transactions one way, then checks the rows and
+* the aggregations of the columns as patched (or reset) against those of rebuilt columns.
+*/
+namespace
+{
+    typedef std::tuple<int, int, int, int, int, int, int, int, int, double, double
+        , long long, long long, long long, long long, int, int> Row;
+
+    /** The rows by TRANSID, with the dense account indexes turned back into ACCOUNTID */
+    std::map<int, Row> rows()
+    {
+        Model_CheckingColumns& columns = Model_CheckingColumns::instance();
+        const Model_CheckingColumns::Columns& c = columns.columns();
+        std::map<int, Row> rows;
+        for (size_t i = 0; i < c.size(); ++i)
+        {
+            rows[c.TRANSID[i]] = Row(c.ACCOUNTID[i], c.TOACCOUNTID[i], c.PAYEEID[i], c.CATEGID[i], c.SUBCATEGID[i]
+                , c.ymd[i], c.type[i], c.status[i], c.as_transfer[i], c.amount[i], c.to_amount[i]
+                , c.balance[i], c.reconciled[i], c.to_balance[i], c.to_reconciled[i]
+                , columns.account_id(c.account[i]), columns.account_id(c.to_account[i]));
+        }
+        return rows;
+    }
+
+    typedef std::tuple<double, double, int, int> Totals;
+
+    /** count() and by_account() of a few filters */
+    std::vector<std::pair<size_t, std::map<int, Totals> > > aggregations()
+    {
+        std::vector<Model_CheckingColumns::Filter> filters(4);
+        filters[1].from_ymd = 20200103;
+        filters[1].to_ymd = 20200107;
+        filters[2].types = 1u << Model_Checking::WITHDRAWAL;
+        filters[3].statuses = ~(1u << Model_Checking::VOID_);
+        filters[3].as_transfer = false;
+
+        std::vector<std::pair<size_t, std::map<int, Totals> > > values;
+        for (const auto& filter : filters)
+        {
+            std::map<int, Totals> totals;
+            for (const auto& account : Model_CheckingColumns::instance().by_account(filter))
+            {
+                const Model_CheckingColumns::Totals& t = account.second;
+                totals[account.first] = Totals(t.balance, t.reconciled, t.count, t.followup);
+            }
+            values.push_back(std::make_pair(Model_CheckingColumns::instance().count(filter), totals));
+        }
+        return values;
+    }
+
+    void check_rebuilt()
+    {
+        const std::map<int, Row> patched_rows = rows();
+        const auto patched = aggregations();
+        Model_CheckingColumns::instance().reset();
+        CHECK(patched_rows == rows());
+        CHECK(patched == aggregations());
+    }
+}
+
+MMEX_TEST(columns_save_insert)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), e = db.account("E", "EUR");
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    rows();
+
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30.25);
+    db.transaction("2020-01-06", a, Model_Checking::TRANSFER, 10, e, 9);
+    db.transaction("2020-01-07", e, Model_Checking::DEPOSIT, 40);
+    CHECK(Model_CheckingColumns::instance().count(Model_CheckingColumns::Filter()) == 4);
+    check_rebuilt();
+}
+
+MMEX_TEST(columns_save_update)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    Model_Checking::Data* r = db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    rows();
+
+    r->TRANSAMOUNT = 35;
+    r->TRANSDATE = "2020-01-03";
+    r->STATUS = Model_Checking::toShortStatus(Model_Checking::all_status()[Model_Checking::FOLLOWUP]);
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+
+    r->TRANSCODE = Model_Checking::all_type()[Model_Checking::TRANSFER];
+    r->TOACCOUNTID = b; // to a transfer
+    r->TOTRANSAMOUNT = 35;
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+
+    r->STATUS = Model_Checking::toShortStatus(Model_Checking::all_status()[Model_Checking::VOID_]);
+    Model_Checking::instance().save(r);
+    check_rebuilt();
+}
+
+MMEX_TEST(columns_remove)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    const int first = db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100)->TRANSID;
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    const int last = db.transaction("2020-01-06", a, Model_Checking::TRANSFER, 10, b, 10)->TRANSID;
+    rows();
+
+    Model_Checking::instance().remove(first); // a row moves into its place
+    check_rebuilt();
+    Model_Checking::instance().remove(last);
+    CHECK(Model_CheckingColumns::instance().count(Model_CheckingColumns::Filter()) == 1);
+    check_rebuilt();
+}
+
+MMEX_TEST(columns_update_where)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    db.transaction("2020-01-06", b, Model_Checking::DEPOSIT, 50);
+    rows();
+
+    Model_Checking::instance().update_where(SET<Model_Checking::TRANSAMOUNT>(40), Model_Checking::ACCOUNTID(a));
+    check_rebuilt();
+
+    Model_Checking::instance().update_where(SET<Model_Checking::ACCOUNTID>(b), Model_Checking::ACCOUNTID(a));
+    CHECK(Model_CheckingColumns::instance().by_account(Model_CheckingColumns::Filter())[b].count == 3);
+    check_rebuilt();
+}
+
+MMEX_TEST(columns_batch_save)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    Model_Checking::Data* deposit = db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    Model_Checking::Data* transfer = db.transaction("2020-01-05", a, Model_Checking::TRANSFER, 30, b, 30);
+    rows();
+
+    deposit->TRANSAMOUNT = 200;
+    transfer->TRANSDATE = "2020-01-01";
+    Model_Checking::Data* added = Model_Checking::instance().create();
+    *added = *deposit;
+    added->TRANSID = -1;
+    added->TRANSDATE = "2020-01-09";
+    std::vector<Model_Checking::Data*> batch = { deposit, transfer, added };
+    Model_Checking::instance().save(batch);
+    CHECK(Model_CheckingColumns::instance().count(Model_CheckingColumns::Filter()) == 3);
+    check_rebuilt();
+
+    // a batch of a single row changes the revision once, like save() of a record
+    std::vector<Model_Checking::Data*> row = { transfer };
+    transfer->TOACCOUNTID = a;
+    Model_Checking::instance().save(row);
+    check_rebuilt();
+}
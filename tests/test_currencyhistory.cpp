@@ -0,0 +1,164 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_Currency.h"
+#include "Model_CurrencyHistory.h"
+
+/*
+* Each test loads the rate timelines, changes the rates one way, then checks the rates of
+* every day around them against those served after the timelines are loaded again.
+*/
+namespace
+{
+    wxDate date(const wxString& iso_date)
+    {
+        wxDate d;
+        d.ParseISODate(iso_date);
+        return d;
+    }
+
+    /** The rates of the currency on the days around the history, as getDayRate(), applyDayRate() and getLastRate() give them */
+    std::vector<double> rates(int currency_id)
+    {
+        std::vector<std::pair<DB_Date, double> > amounts;
+        for (int ymd = 20191225; ymd <= 20191231; ++ymd)
+            amounts.push_back(std::make_pair(DB_Date(ymd), 1.0));
+        for (int ymd = 20200101; ymd <= 20200125; ++ymd)
+            amounts.push_back(std::make_pair(DB_Date(ymd), 1.0));
+
+        std::vector<double> values;
+        for (const auto& amount : amounts)
+            values.push_back(Model_CurrencyHistory::getDayRate(currency_id, amount.first));
+        Model_CurrencyHistory::applyDayRate(currency_id, amounts);
+        for (const auto& amount : amounts)
+            values.push_back(amount.second);
+        values.push_back(Model_CurrencyHistory::getLastRate(currency_id));
+        values.push_back(Model_CurrencyHistory::getLastRate(currency_id, "2020-01-10"));
+        return values;
+    }
+
+    std::vector<double> rates()
+    {
+        std::vector<double> values = rates(Model_Currency::instance().GetCurrencyRecord("EUR")->CURRENCYID);
+        const std::vector<double> gbp = rates(Model_Currency::instance().GetCurrencyRecord("GBP")->CURRENCYID);
+        values.insert(values.end(), gbp.begin(), gbp.end());
+        return values;
+    }
+
+    /** The records of the table are not to be held across, destroy_cache() makes the timelines load again */
+    void check_reloaded()
+    {
+        const std::vector<double> patched = rates();
+        Model_CurrencyHistory::instance().destroy_cache();
+        CHECK(patched == rates());
+    }
+}
+
+MMEX_TEST(currency_add_update)
+{
+    mmTestDatabase db;
+    const int eur = Model_Currency::instance().GetCurrencyRecord("EUR")->CURRENCYID;
+    const int gbp = Model_Currency::instance().GetCurrencyRecord("GBP")->CURRENCYID;
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-05"), 1.5, Model_CurrencyHistory::MANUAL);
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-10"), 1.6, Model_CurrencyHistory::MANUAL);
+    rates();
+
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-07"), 1.7, Model_CurrencyHistory::MANUAL);
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20200106)) == 1.5); // the earlier one on a tie
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20200109)) == 1.6);
+    check_reloaded();
+
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2019-12-31"), 1.1, Model_CurrencyHistory::ONLINE); // before all
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-20"), 1.2, Model_CurrencyHistory::ONLINE); // after all
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-07"), 1.8, Model_CurrencyHistory::MANUAL); // the same day
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20200107)) == 1.8);
+    check_reloaded();
+
+    Model_CurrencyHistory::instance().addUpdate(gbp, date("2020-01-03"), 0.9, Model_CurrencyHistory::MANUAL); // a new timeline
+    CHECK(Model_CurrencyHistory::getLastRate(gbp) == 0.9);
+    check_reloaded();
+}
+
+MMEX_TEST(currency_save_remove)
+{
+    mmTestDatabase db;
+    const int eur = Model_Currency::instance().GetCurrencyRecord("EUR")->CURRENCYID;
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-05"), 1.5, Model_CurrencyHistory::MANUAL);
+    const int removed = Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-10"), 1.6, Model_CurrencyHistory::MANUAL);
+    rates();
+
+    Model_CurrencyHistory::Data* r = Model_CurrencyHistory::instance().create();
+    r->CURRENCYID = eur;
+    r->CURRDATE = "2020-01-15";
+    r->CURRVALUE = 1.9;
+    r->CURRUPDTYPE = Model_CurrencyHistory::MANUAL;
+    Model_CurrencyHistory::instance().save(r);
+    CHECK(Model_CurrencyHistory::getLastRate(eur) == 1.9);
+    check_reloaded();
+
+    Model_CurrencyHistory::instance().remove(removed);
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20200110)) == 1.5);
+    check_reloaded();
+}
+
+MMEX_TEST(currency_update_where)
+{
+    mmTestDatabase db;
+    const int eur = Model_Currency::instance().GetCurrencyRecord("EUR")->CURRENCYID;
+    const int gbp = Model_Currency::instance().GetCurrencyRecord("GBP")->CURRENCYID;
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-05"), 1.5, Model_CurrencyHistory::MANUAL);
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-10"), 1.6, Model_CurrencyHistory::MANUAL);
+    rates();
+
+    Model_CurrencyHistory::instance().update_where(SET<Model_CurrencyHistory::CURRVALUE>(2.0)
+        , Model_CurrencyHistory::CURRENCYID(eur));
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20200105)) == 2.0);
+    check_reloaded();
+
+    Model_CurrencyHistory::instance().update_where(SET<Model_CurrencyHistory::CURRENCYID>(gbp)
+        , Model_CurrencyHistory::CURRENCYID(eur));
+    CHECK(Model_CurrencyHistory::getLastRate(gbp) == 2.0);
+    check_reloaded();
+}
+
+MMEX_TEST(currency_batch_save)
+{
+    mmTestDatabase db;
+    const int eur = Model_Currency::instance().GetCurrencyRecord("EUR")->CURRENCYID;
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-05"), 1.5, Model_CurrencyHistory::MANUAL);
+    Model_CurrencyHistory::instance().addUpdate(eur, date("2020-01-10"), 1.6, Model_CurrencyHistory::MANUAL);
+    rates();
+
+    Model_CurrencyHistory::Data_Set rows = Model_CurrencyHistory::instance().all();
+    for (auto& r : rows) r.CURRVALUE += 1;
+    Model_CurrencyHistory::Data added;
+    added.CURRENCYID = eur;
+    added.CURRDATE = "2020-01-01";
+    added.CURRVALUE = 3.0;
+    added.CURRUPDTYPE = Model_CurrencyHistory::ONLINE;
+    rows.push_back(added);
+    Model_CurrencyHistory::instance().save(rows);
+    CHECK(Model_CurrencyHistory::getDayRate(eur, DB_Date(20191231)) == 3.0);
+    check_reloaded();
+
+    // a batch of a single row changes the revision once, like the save() of addUpdate()
+    Model_CurrencyHistory::Data_Set row;
+    row.push_back(rows[0]);
+    row[0].CURRDATE = "2020-01-20";
+    Model_CurrencyHistory::instance().save(row);
+    check_reloaded();
+}
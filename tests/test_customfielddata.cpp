@@ -0,0 +1,202 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_CustomField.h"
+#include "Model_CustomFieldData.h"
+
+/*
+* Each test loads the UDFC index of the transactions, changes the custom field data one way,
+* then checks the contents of every record and slot against those read from the database.
+*/
+namespace
+{
+    const int REFS = 4;
+
+    /** The contents of the records 1 .. REFS in the slots UDFC01 .. UDFC05, as indexed */
+    std::vector<wxString> indexed()
+    {
+        const Model_CustomFieldData::UDFC_Index& index = Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION);
+        std::vector<wxString> contents;
+        for (int ref_id = 1; ref_id <= REFS; ++ref_id)
+        {
+            for (int slot = 0; slot < Model_CustomFieldData::UDFC_SLOTS; ++slot)
+                contents.push_back(index.content(ref_id, slot));
+        }
+        return contents;
+    }
+
+    std::vector<wxString> stored()
+    {
+        const wxString& reftype = Model_Attachment::reftype_desc(Model_Attachment::TRANSACTION);
+        const wxArrayString& names = Model_CustomField::UDFC_FIELDS();
+        std::vector<wxString> contents;
+        for (int ref_id = 1; ref_id <= REFS; ++ref_id)
+        {
+            for (int slot = 0; slot < Model_CustomFieldData::UDFC_SLOTS; ++slot)
+            {
+                const int field_id = Model_CustomField::getUDFCID(reftype, names[slot + 1]); // names[0] is no UDFC
+                const Model_CustomFieldData::Data_Set data = Model_CustomFieldData::instance()
+                    .find(Model_CustomFieldData::FIELDID(field_id), Model_CustomFieldData::REFID(ref_id));
+                contents.push_back(data.empty() ? wxString() : data[0].CONTENT);
+            }
+        }
+        return contents;
+    }
+
+    void check_stored()
+    {
+        CHECK(indexed() == stored());
+    }
+
+    /** Add a custom field of the transactions shown in the UDFC column, none for an empty udfc */
+    int field(const wxString& description, const wxString& udfc)
+    {
+        Model_CustomField::Data* r = Model_CustomField::instance().create();
+        r->REFTYPE = Model_Attachment::reftype_desc(Model_Attachment::TRANSACTION);
+        r->DESCRIPTION = description;
+        r->TYPE = Model_CustomField::fieldtype_desc(Model_CustomField::STRING);
+        r->PROPERTIES = Model_CustomField::formatProperties("", "", false, "", wxArrayString(), 0, udfc);
+        return Model_CustomField::instance().save(r);
+    }
+
+    Model_CustomFieldData::Data* data(int field_id, int ref_id, const wxString& content)
+    {
+        Model_CustomFieldData::Data* r = Model_CustomFieldData::instance().create();
+        r->FIELDID = field_id;
+        r->REFID = ref_id;
+        r->CONTENT = content;
+        Model_CustomFieldData::instance().save(r);
+        return r;
+    }
+}
+
+MMEX_TEST(udfc_save_insert)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01"), f3 = field("Three", "UDFC03"), hidden = field("Hidden", "");
+    data(f1, 1, "a");
+    indexed();
+
+    data(f1, 2, "b");
+    data(f3, 2, "c");
+    data(hidden, 3, "not shown");
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(2, 2) == "c");
+    check_stored();
+}
+
+MMEX_TEST(udfc_save_update)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01"), f2 = field("Two", "UDFC02"), hidden = field("Hidden", "");
+    Model_CustomFieldData::Data* r = data(f1, 1, "a");
+    data(f2, 2, "b");
+    indexed();
+
+    r->CONTENT = "changed";
+    Model_CustomFieldData::instance().save(r);
+    check_stored();
+
+    r->REFID = 3; // to another record
+    Model_CustomFieldData::instance().save(r);
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(1, 0).empty());
+    check_stored();
+
+    r->FIELDID = f2; // to another slot
+    Model_CustomFieldData::instance().save(r);
+    check_stored();
+
+    r->FIELDID = hidden; // out of the slots
+    Model_CustomFieldData::instance().save(r);
+    check_stored();
+}
+
+MMEX_TEST(udfc_remove)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01"), f5 = field("Five", "UDFC05");
+    const int a = data(f1, 1, "a")->FIELDATADID;
+    const int b = data(f5, 1, "b")->FIELDATADID;
+    data(f5, 4, "c");
+    indexed();
+
+    Model_CustomFieldData::instance().remove(a);
+    check_stored();
+    Model_CustomFieldData::instance().remove(b);
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(1, 4).empty());
+    check_stored();
+}
+
+MMEX_TEST(udfc_update_where)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01"), f2 = field("Two", "UDFC02");
+    data(f1, 1, "a");
+    data(f1, 2, "b");
+    data(f2, 2, "c");
+    indexed();
+
+    Model_CustomFieldData::instance().update_where(SET<Model_CustomFieldData::CONTENT>(wxString("same"))
+        , Model_CustomFieldData::FIELDID(f1));
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(2, 0) == "same");
+    check_stored();
+
+    Model_CustomFieldData::instance().update_where(SET<Model_CustomFieldData::REFID>(3)
+        , Model_CustomFieldData::REFID(2));
+    check_stored();
+}
+
+MMEX_TEST(udfc_batch_save)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01"), f2 = field("Two", "UDFC02");
+    data(f1, 1, "a");
+    data(f2, 1, "b");
+    indexed();
+
+    Model_CustomFieldData::Data_Set rows = Model_CustomFieldData::instance().find(Model_CustomFieldData::REFID(1));
+    for (auto& r : rows) r.CONTENT += "+";
+    Model_CustomFieldData::Data added;
+    added.FIELDID = f2;
+    added.REFID = 4;
+    added.CONTENT = "d";
+    rows.push_back(added);
+    Model_CustomFieldData::instance().save(rows);
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(4, 1) == "d");
+    check_stored();
+
+    // a batch of a single row changes the revision once, like save() of a record
+    Model_CustomFieldData::Data_Set row;
+    row.push_back(rows[0]);
+    row[0].REFID = 2;
+    Model_CustomFieldData::instance().save(row);
+    check_stored();
+}
+
+MMEX_TEST(udfc_field_changes)
+{
+    mmTestDatabase db;
+    const int f1 = field("One", "UDFC01");
+    data(f1, 1, "a");
+    indexed();
+
+    // moving the field to another slot reloads the index
+    Model_CustomField::Data* r = Model_CustomField::instance().get(f1);
+    r->PROPERTIES = Model_CustomField::formatProperties("", "", false, "", wxArrayString(), 0, "UDFC04");
+    Model_CustomField::instance().save(r);
+    CHECK(Model_CustomFieldData::instance().get_udfc(Model_Attachment::TRANSACTION).content(1, 3) == "a");
+    check_stored();
+}
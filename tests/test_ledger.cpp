@@ -0,0 +1,194 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_Ledger.h"
+
+/*
+* Each test builds the ledgers, changes the transactions one way, then checks the ledgers
+* as patched (or reset) by the change against ledgers rebuilt from the database.
+*/
+namespace
+{
+    /** The balances of the accounts in total and on every day around the transactions, both variants */
+    std::vector<double> balances(const std::vector<int>& accounts)
+    {
+        std::vector<int> days(1, 20191231);
+        for (int ymd = 20200101; ymd <= 20200111; ++ymd)
+            days.push_back(ymd);
+
+        Model_Ledger& ledger = Model_Ledger::instance();
+        std::vector<double> values;
+        for (const auto& account_id : accounts)
+        {
+            for (int v = 0; v < Model_Ledger::MAX_VARIANT; ++v)
+            {
+                const Model_Ledger::VARIANT variant = static_cast<Model_Ledger::VARIANT>(v);
+                values.push_back(ledger.balance(account_id, variant));
+                for (const auto& ymd : days)
+                    values.push_back(ledger.balance(account_id, DB_Date(ymd), variant));
+            }
+        }
+        return values;
+    }
+
+    void check_rebuilt(const std::vector<int>& accounts)
+    {
+        const std::vector<double> patched = balances(accounts);
+        Model_Ledger::instance().reset();
+        CHECK(patched == balances(accounts));
+    }
+}
+
+MMEX_TEST(ledger_save_insert)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    const std::vector<int> accounts = { a, b };
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    balances(accounts);
+
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 20); // same day, after by TRANSID
+    db.transaction("2020-01-01", a, Model_Checking::DEPOSIT, 5); // before all
+    db.transaction("2020-01-03", a, Model_Checking::TRANSFER, 10, b, 12);
+    CHECK(Model_Ledger::instance().balance(a) == 45);
+    CHECK(Model_Ledger::instance().balance(a, DB_Date(20200104)) == 95);
+    CHECK(Model_Ledger::instance().balance(b) == 12);
+    check_rebuilt(accounts);
+}
+
+MMEX_TEST(ledger_save_update)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const std::vector<int> accounts = { a };
+    Model_Checking::Data* first = db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    Model_Checking::Data* second = db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    Model_Checking::Data* third = db.transaction("2020-01-07", a, Model_Checking::WITHDRAWAL, 10);
+    balances(accounts);
+
+    first->TRANSAMOUNT = 60;
+    first->TRANSDATE = "2020-01-08"; // moves after the others
+    Model_Checking::instance().save(first);
+    CHECK(Model_Ledger::instance().balance(a, DB_Date(20200107)) == -40);
+    check_rebuilt(accounts);
+
+    second->STATUS = Model_Checking::toShortStatus(Model_Checking::all_status()[Model_Checking::RECONCILED]);
+    Model_Checking::instance().save(second);
+    third->STATUS = Model_Checking::toShortStatus(Model_Checking::all_status()[Model_Checking::VOID_]);
+    Model_Checking::instance().save(third);
+    CHECK(Model_Ledger::instance().balance(a) == 30);
+    CHECK(Model_Ledger::instance().balance(a, Model_Ledger::RECONCILED) == -30);
+    check_rebuilt(accounts);
+}
+
+MMEX_TEST(ledger_remove)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    const std::vector<int> accounts = { a, b };
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    const int withdrawal = db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int transfer = db.transaction("2020-01-03", a, Model_Checking::TRANSFER, 10, b, 10)->TRANSID;
+    balances(accounts);
+
+    Model_Checking::instance().remove(withdrawal);
+    CHECK(Model_Ledger::instance().balance(a) == 90);
+    check_rebuilt(accounts);
+
+    Model_Checking::instance().remove(transfer);
+    CHECK(Model_Ledger::instance().balance(a) == 100);
+    CHECK(Model_Ledger::instance().balance(b) == 0);
+    check_rebuilt(accounts);
+}
+
+MMEX_TEST(ledger_transfer_accounts)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B"), c = db.account("C");
+    const std::vector<int> accounts = { a, b, c };
+    db.transaction("2020-01-02", b, Model_Checking::DEPOSIT, 100);
+    Model_Checking::Data* transfer = db.transaction("2020-01-04", a, Model_Checking::TRANSFER, 10, b, 12);
+    balances(accounts);
+
+    transfer->ACCOUNTID = b;
+    transfer->TOACCOUNTID = c;
+    Model_Checking::instance().save(transfer);
+    CHECK(Model_Ledger::instance().balance(a) == 0);
+    CHECK(Model_Ledger::instance().balance(b) == 90);
+    CHECK(Model_Ledger::instance().balance(c) == 12);
+    check_rebuilt(accounts);
+
+    transfer->TOACCOUNTID = a;
+    transfer->TRANSDATE = "2020-01-01";
+    Model_Checking::instance().save(transfer);
+    check_rebuilt(accounts);
+
+    transfer->TRANSCODE = Model_Checking::all_type()[Model_Checking::WITHDRAWAL];
+    transfer->TOACCOUNTID = -1;
+    Model_Checking::instance().save(transfer);
+    CHECK(Model_Ledger::instance().balance(a) == 0);
+    check_rebuilt(accounts);
+}
+
+MMEX_TEST(ledger_update_where)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    const std::vector<int> accounts = { a, b };
+    db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    db.transaction("2020-01-05", a, Model_Checking::WITHDRAWAL, 30);
+    db.transaction("2020-01-06", b, Model_Checking::DEPOSIT, 50);
+    balances(accounts);
+
+    Model_Checking::instance().update_where(SET<Model_Checking::TRANSAMOUNT>(40), Model_Checking::ACCOUNTID(a));
+    CHECK(Model_Ledger::instance().balance(a) == 0);
+    check_rebuilt(accounts);
+
+    Model_Checking::instance().update_where(SET<Model_Checking::ACCOUNTID>(b), Model_Checking::ACCOUNTID(a));
+    CHECK(Model_Ledger::instance().balance(a) == 0);
+    CHECK(Model_Ledger::instance().balance(b) == 50);
+    check_rebuilt(accounts);
+}
+
+MMEX_TEST(ledger_batch_save)
+{
+    mmTestDatabase db;
+    const int a = db.account("A"), b = db.account("B");
+    const std::vector<int> accounts = { a, b };
+    Model_Checking::Data* deposit = db.transaction("2020-01-02", a, Model_Checking::DEPOSIT, 100);
+    Model_Checking::Data* transfer = db.transaction("2020-01-05", a, Model_Checking::TRANSFER, 30, b, 30);
+    balances(accounts);
+
+    deposit->TRANSAMOUNT = 200;
+    transfer->TRANSDATE = "2020-01-01";
+    Model_Checking::Data* added = Model_Checking::instance().create();
+    *added = *deposit;
+    added->TRANSID = -1;
+    added->TRANSDATE = "2020-01-09";
+    std::vector<Model_Checking::Data*> rows = { deposit, transfer, added };
+    Model_Checking::instance().save(rows);
+    CHECK(Model_Ledger::instance().balance(a) == 370);
+    check_rebuilt(accounts);
+
+    // a single row changes the revision once, like a patch that did not come
+    std::vector<Model_Checking::Data*> row = { transfer };
+    transfer->TOACCOUNTID = a;
+    Model_Checking::instance().save(row);
+    CHECK(Model_Ledger::instance().balance(b) == 0);
+    check_rebuilt(accounts);
+}
@@ -0,0 +1,191 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_Ledger.h"
+
+/*
+* Each test builds the ledgers, changes the transactions one way, then checks the ledgers
+* as patched (or reset) by the change against ledgers rebuilt from the database.
+*/
+#include "Model_Splittransaction.h"
+#include <algorithm>
+
+/*
+* Each test loads the split index, changes the splits one way, then checks the splits of
+* every transaction in the index against those read from the database.
+*/
+namespace
+{
+    /** The splits of the transaction as JSON, ordered by SPLITTRANSID */
+    std::vector<wxString> indexed(int trans_id)
+    {
+        std::vector<wxString> rows;
+        for (const auto& r : Model_Splittransaction::instance().get_all()[trans_id])
+            rows.push_back(r.to_json());
+        return rows;
+    }
+
+    std::vector<wxString> stored(int trans_id)
+    {
+        Model_Splittransaction::Data_Set splits = Model_Splittransaction::instance().find(Model_Splittransaction::TRANSID(trans_id));
+        std::sort(splits.begin(), splits.end());
+        std::vector<wxString> rows;
+        for (const auto& r : splits)
+            rows.push_back(r.to_json());
+        return rows;
+    }
+
+    void check_stored(const std::vector<int>& trans_ids)
+    {
+        size_t count = 0;
+        for (const auto& trans_id : trans_ids)
+        {
+            CHECK(indexed(trans_id) == stored(trans_id));
+            count += stored(trans_id).size();
+        }
+        CHECK(Model_Splittransaction::instance().get_all().size() == count);
+    }
+
+    Model_Splittransaction::Data* split(int trans_id, int categ_id, double amount)
+    {
+        Model_Splittransaction::Data* r = Model_Splittransaction::instance().create();
+        r->TRANSID = trans_id;
+        r->CATEGID = categ_id;
+        r->SUBCATEGID = -1;
+        r->SPLITTRANSAMOUNT = amount;
+        Model_Splittransaction::instance().save(r);
+        return r;
+    }
+}
+
+MMEX_TEST(split_save_insert)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-02", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-01-03", a, Model_Checking::WITHDRAWAL, 50)->TRANSID;
+    const int t3 = db.transaction("2020-01-04", a, Model_Checking::WITHDRAWAL, 70)->TRANSID;
+    const std::vector<int> trans_ids = { t1, t2, t3 };
+    split(t2, 1, 20);
+    split(t2, 2, 30);
+    Model_Splittransaction::instance().get_all();
+
+    split(t3, 1, 70); // a new last transaction
+    split(t1, 1, 10); // a new first transaction
+    split(t2, 3, 5);
+    split(t1, 2, 20);
+    CHECK(Model_Splittransaction::instance().get_all()[t1].size() == 2);
+    CHECK(Model_Splittransaction::instance().get_all()[t2].size() == 3);
+    check_stored(trans_ids);
+}
+
+MMEX_TEST(split_save_update)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-02", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-01-03", a, Model_Checking::WITHDRAWAL, 50)->TRANSID;
+    const std::vector<int> trans_ids = { t1, t2 };
+    Model_Splittransaction::Data* moved = split(t1, 1, 10);
+    split(t1, 2, 20);
+    split(t2, 1, 50);
+    Model_Splittransaction::instance().get_all();
+
+    moved->SPLITTRANSAMOUNT = 15;
+    Model_Splittransaction::instance().save(moved);
+    check_stored(trans_ids);
+
+    moved->TRANSID = t2; // to another transaction
+    Model_Splittransaction::instance().save(moved);
+    CHECK(Model_Splittransaction::instance().get_all()[t1].size() == 1);
+    check_stored(trans_ids);
+}
+
+MMEX_TEST(split_remove)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-02", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-01-03", a, Model_Checking::WITHDRAWAL, 50)->TRANSID;
+    const std::vector<int> trans_ids = { t1, t2 };
+    const int first = split(t1, 1, 10)->SPLITTRANSID;
+    const int only = split(t2, 1, 50)->SPLITTRANSID;
+    split(t1, 2, 20);
+    Model_Splittransaction::instance().get_all();
+
+    Model_Splittransaction::instance().remove(first);
+    check_stored(trans_ids);
+
+    Model_Splittransaction::instance().remove(only); // the transaction leaves the index
+    CHECK(Model_Splittransaction::instance().get_all()[t2].empty());
+    check_stored(trans_ids);
+}
+
+MMEX_TEST(split_update_where)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-02", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-01-03", a, Model_Checking::WITHDRAWAL, 50)->TRANSID;
+    const std::vector<int> trans_ids = { t1, t2 };
+    split(t1, 1, 10);
+    split(t1, 2, 20);
+    split(t2, 1, 50);
+    Model_Splittransaction::instance().get_all();
+
+    Model_Splittransaction::instance().update_where(SET<Model_Splittransaction::SPLITTRANSAMOUNT>(5)
+        , Model_Splittransaction::TRANSID(t1));
+    check_stored(trans_ids);
+
+    Model_Splittransaction::instance().update_where(SET<Model_Splittransaction::TRANSID>(t2)
+        , Model_Splittransaction::CATEGID(1));
+    CHECK(Model_Splittransaction::instance().get_all()[t2].size() == 2);
+    check_stored(trans_ids);
+}
+
+MMEX_TEST(split_batch_save)
+{
+    mmTestDatabase db;
+    const int a = db.account("A");
+    const int t1 = db.transaction("2020-01-02", a, Model_Checking::WITHDRAWAL, 30)->TRANSID;
+    const int t2 = db.transaction("2020-01-03", a, Model_Checking::WITHDRAWAL, 50)->TRANSID;
+    const std::vector<int> trans_ids = { t1, t2 };
+    split(t1, 1, 10);
+    split(t2, 1, 50);
+    Model_Splittransaction::instance().get_all();
+
+    // update() removes the splits of the transaction, then saves the new ones in a batch
+    Model_Splittransaction::Data_Set rows;
+    for (int categ_id = 1; categ_id <= 3; ++categ_id)
+    {
+        Model_Splittransaction::Data r;
+        r.CATEGID = categ_id;
+        r.SUBCATEGID = -1;
+        r.SPLITTRANSAMOUNT = 10;
+        rows.push_back(r);
+    }
+    Model_Splittransaction::instance().update(rows, t1);
+    CHECK(Model_Splittransaction::instance().get_all()[t1].size() == 3);
+    check_stored(trans_ids);
+
+    // a batch of a single row changes the revision once, like save() of a record
+    Model_Splittransaction::Data_Set row = Model_Splittransaction::instance().find(Model_Splittransaction::TRANSID(t2));
+    row[0].TRANSID = t1;
+    Model_Splittransaction::instance().save(row);
+    CHECK(Model_Splittransaction::instance().get_all()[t2].empty());
+    check_stored(trans_ids);
+}
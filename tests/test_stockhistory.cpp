@@ -0,0 +1,154 @@
+/*******************************************************
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ ********************************************************/
+
+#include "test.h"
+#include "Model_StockHistory.h"
+
+/*
+* Each test loads the price series, changes the prices one way, then checks the prices of
+* every day around them against those served after the series are loaded again.
+*/
+namespace
+{
+    wxDate date(const wxString& iso_date)
+    {
+        wxDate d;
+        d.ParseISODate(iso_date);
+        return d;
+    }
+
+    /** The last and the nearest prices of the symbols on the days around the history */
+    std::vector<double> prices()
+    {
+        std::vector<int> days;
+        for (int ymd = 20191225; ymd <= 20191231; ++ymd)
+            days.push_back(ymd);
+        for (int ymd = 20200101; ymd <= 20200125; ++ymd)
+            days.push_back(ymd);
+
+        std::vector<double> values;
+        for (const wxString symbol : { "AAA", "BBB" })
+        {
+            for (const auto& ymd : days)
+            {
+                values.push_back(Model_StockHistory::instance().getLastPrice(symbol, DB_Date(ymd)));
+                values.push_back(Model_StockHistory::instance().getNearestPrice(symbol, DB_Date(ymd)));
+            }
+        }
+        return values;
+    }
+
+    /** The records of the table are not to be held across, destroy_cache() makes the series load again */
+    void check_reloaded()
+    {
+        const std::vector<double> patched = prices();
+        Model_StockHistory::instance().destroy_cache();
+        CHECK(patched == prices());
+    }
+}
+
+MMEX_TEST(stock_add_update)
+{
+    mmTestDatabase db;
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-05"), 10, Model_StockHistory::MANUAL);
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-10"), 12, Model_StockHistory::MANUAL);
+    prices();
+
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-07"), 11, Model_StockHistory::MANUAL);
+    CHECK(Model_StockHistory::instance().getNearestPrice("AAA", DB_Date(20200106)) == 10); // the earlier one on a tie
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200109)) == 11);
+    check_reloaded();
+
+    Model_StockHistory::instance().addUpdate("AAA", date("2019-12-31"), 9, Model_StockHistory::ONLINE); // before all
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-20"), 13, Model_StockHistory::ONLINE); // after all
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-07"), 14, Model_StockHistory::MANUAL); // the same day
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200107)) == 14);
+    check_reloaded();
+
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-10"), 0, Model_StockHistory::MANUAL); // a zero price is no price
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200110)) == 14);
+    check_reloaded();
+
+    Model_StockHistory::instance().addUpdate("BBB", date("2020-01-03"), 50, Model_StockHistory::MANUAL); // a new series
+    CHECK(Model_StockHistory::instance().getNearestPrice("BBB", DB_Date(20191225)) == 50);
+    check_reloaded();
+}
+
+MMEX_TEST(stock_save_remove)
+{
+    mmTestDatabase db;
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-05"), 10, Model_StockHistory::MANUAL);
+    const int removed = Model_StockHistory::instance().addUpdate("AAA", date("2020-01-10"), 12, Model_StockHistory::MANUAL);
+    prices();
+
+    Model_StockHistory::Data* r = Model_StockHistory::instance().create();
+    r->SYMBOL = "AAA";
+    r->DATE = "2020-01-15";
+    r->VALUE = 15;
+    r->UPDTYPE = Model_StockHistory::MANUAL;
+    Model_StockHistory::instance().save(r);
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200125)) == 15);
+    check_reloaded();
+
+    Model_StockHistory::instance().remove(removed);
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200110)) == 10);
+    check_reloaded();
+}
+
+MMEX_TEST(stock_update_where)
+{
+    mmTestDatabase db;
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-05"), 10, Model_StockHistory::MANUAL);
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-10"), 12, Model_StockHistory::MANUAL);
+    prices();
+
+    Model_StockHistory::instance().update_where(SET<Model_StockHistory::VALUE>(20.0)
+        , Model_StockHistory::SYMBOL("AAA"));
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200105)) == 20);
+    check_reloaded();
+
+    Model_StockHistory::instance().update_where(SET<Model_StockHistory::SYMBOL>(wxString("BBB"))
+        , Model_StockHistory::SYMBOL("AAA"));
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200125)) == 0);
+    check_reloaded();
+}
+
+MMEX_TEST(stock_batch_save)
+{
+    mmTestDatabase db;
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-05"), 10, Model_StockHistory::MANUAL);
+    Model_StockHistory::instance().addUpdate("AAA", date("2020-01-10"), 12, Model_StockHistory::MANUAL);
+    prices();
+
+    Model_StockHistory::Data_Set rows = Model_StockHistory::instance().all();
+    for (auto& r : rows) r.VALUE += 1;
+    Model_StockHistory::Data added;
+    added.SYMBOL = "BBB";
+    added.DATE = "2020-01-01";
+    added.VALUE = 30;
+    added.UPDTYPE = Model_StockHistory::ONLINE;
+    rows.push_back(added);
+    Model_StockHistory::instance().save(rows);
+    CHECK(Model_StockHistory::instance().getLastPrice("AAA", DB_Date(20200110)) == 13);
+    check_reloaded();
+
+    // a batch of a single row changes the revision once, like the save() of addUpdate()
+    Model_StockHistory::Data_Set row;
+    row.push_back(rows[0]);
+    row[0].DATE = "2020-01-20";
+    Model_StockHistory::instance().save(row);
+    check_reloaded();
+}